@@ -0,0 +1,170 @@
+// Runs the MCP3008 and ADS1115 drivers against a mock bus: checks that
+// every scanned channel decodes to the value the mock put on the wire,
+// and reports driver CPU cost and modelled bus throughput per conversion.
+// The mock ADS1115 runs at the slow end of its oscillator tolerance, so
+// reading the result before its ready bit is set counts as an error.
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "adc.h"
+
+#define BENCH_SCANS 200000
+#define SPI_BAUD 1000000.0 // Bits per second on the mock SPI bus
+#define I2C_BAUD 400000.0  // Fast-mode I2C
+#define ADS1115_SLOW_CONVERSION (1.1 / 860) // 860 SPS with the oscillator 10% slow
+
+// Struct definitions
+struct mock_bus
+{
+    int counts[8];       // Value each channel converts to
+    unsigned config;     // Last ADS1115 config written
+    double ready_time;   // bus_time at which its conversion completes
+    double bus_time;     // Modelled seconds spent on the wire
+    unsigned long calls; // Bus transactions
+    int protocol_errors;
+};
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int mock_spi_transfer(void *ctx, char *tx, char *rx, unsigned frame_len, unsigned frames)
+{
+    struct mock_bus *mock = ctx;
+    mock->calls++;
+    for (unsigned i = 0; i < frames; i++)
+    {
+        unsigned char *in = (unsigned char *)tx + i * frame_len;
+        unsigned char *out = (unsigned char *)rx + i * frame_len;
+        if (frame_len != MCP3008_FRAME || in[0] != 0x01 || !(in[1] & 0x80))
+        {
+            mock->protocol_errors++;
+            continue;
+        }
+        int value = mock->counts[(in[1] >> 4) & 0x07];
+        out[0] = 0;
+        out[1] = (value >> 8) & 0x03;
+        out[2] = value & 0xff;
+        mock->bus_time += frame_len * 8 / SPI_BAUD;
+    }
+    return 0;
+}
+
+static int mock_i2c_write_reg(void *ctx, unsigned reg, char *buf, unsigned count)
+{
+    struct mock_bus *mock = ctx;
+    mock->calls++;
+    if (reg != ADS1115_REG_CONFIG || count != 2)
+    {
+        mock->protocol_errors++;
+        return 0;
+    }
+    mock->config = ((unsigned char)buf[0] << 8) | (unsigned char)buf[1];
+    mock->bus_time += (2 + count) * 9 / I2C_BAUD; // Address, register, data
+    mock->ready_time = mock->bus_time + ADS1115_SLOW_CONVERSION;
+    return 0;
+}
+
+static int mock_i2c_read_reg(void *ctx, unsigned reg, char *buf, unsigned count)
+{
+    struct mock_bus *mock = ctx;
+    mock->calls++;
+    // Address, register, address, then the data shows what is latched by now
+    mock->bus_time += 3 * 9 / I2C_BAUD;
+    int ready = mock->bus_time >= mock->ready_time;
+    mock->bus_time += count * 9 / I2C_BAUD;
+    if (reg == ADS1115_REG_CONFIG && count == 2)
+    {
+        unsigned config = (mock->config & ~ADS1115_CONFIG_OS) | (ready ? ADS1115_CONFIG_OS : 0);
+        buf[0] = (char)(config >> 8);
+        buf[1] = (char)(config & 0xff);
+        return 0;
+    }
+    // The result register still holds the previous conversion until ready
+    if (reg != ADS1115_REG_CONVERSION || count != 2 || !(mock->config & 0x4000) || !ready)
+    {
+        mock->protocol_errors++;
+        return 0;
+    }
+    int value = mock->counts[(mock->config >> 12) & 0x03];
+    buf[0] = (char)(value >> 8);
+    buf[1] = (char)(value & 0xff);
+    return 0;
+}
+
+static void mock_delay(void *ctx, double seconds)
+{
+    struct mock_bus *mock = ctx;
+    mock->bus_time += seconds;
+}
+
+static int run(const char *name, int type, int channels_available, int max_count, double volts_per_count)
+{
+    struct mock_bus mock = {0};
+    struct adc_bus bus = {&mock, mock_spi_transfer, mock_i2c_write_reg, mock_i2c_read_reg, mock_delay};
+    struct adc adc;
+    adc_init(&adc, type, &bus);
+
+    int channels[ADC_MAX_SCAN];
+    float volts[ADC_MAX_SCAN];
+    int scan_size = channels_available * 2; // Every channel twice per scan
+    for (int i = 0; i < scan_size; i++)
+    {
+        channels[i] = i % channels_available;
+    }
+
+    // Correctness: random values on every channel, many rounds
+    int mismatches = 0;
+    for (int round = 0; round < 1000; round++)
+    {
+        for (int c = 0; c < channels_available; c++)
+        {
+            mock.counts[c] = rand() % max_count;
+        }
+        if (adc_scan(&adc, channels, scan_size, volts) != scan_size)
+        {
+            mismatches++;
+            continue;
+        }
+        for (int i = 0; i < scan_size; i++)
+        {
+            double expected = mock.counts[channels[i]] * volts_per_count;
+            if (volts[i] < expected - 1e-4 || volts[i] > expected + 1e-4)
+            {
+                mismatches++;
+            }
+        }
+    }
+
+    // Throughput
+    mock.bus_time = 0;
+    mock.calls = 0;
+    double start = now_seconds();
+    for (int i = 0; i < BENCH_SCANS; i++)
+    {
+        adc_scan(&adc, channels, scan_size, volts);
+    }
+    double cpu = now_seconds() - start;
+    double conversions = (double)BENCH_SCANS * scan_size;
+
+    printf("%-8s %s: driver %.1f ns/conversion, %.2f bus calls/scan, bus-limited %.0f conversions/s\n",
+           name, (mismatches || mock.protocol_errors) ? "FAIL" : "ok",
+           cpu * 1e9 / conversions, (double)mock.calls / BENCH_SCANS, conversions / mock.bus_time);
+    if (mismatches || mock.protocol_errors)
+    {
+        printf("         %d decode mismatches, %d protocol errors\n", mismatches, mock.protocol_errors);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void)
+{
+    int failed = 0;
+    failed |= run("MCP3008", ADC_MCP3008, 8, 1024, MCP3008_VREF / 1024.0);
+    failed |= run("ADS1115", ADC_ADS1115, 4, 32768, ADS1115_FULL_SCALE / 32768.0);
+    return failed;
+}
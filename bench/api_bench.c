@@ -0,0 +1,234 @@
+// Load test for the control socket. Runs the daemon's loop shape, a
+// periodic timerfd plus the API descriptor on one epoll, with a control
+// tick every BENCH_PERIOD_MS that publishes a sample. Subscriber and
+// polling clients are separate processes. Reports the tick period's
+// jitter with no clients and with dozens of subscribers, the loop time
+// spent on the API, and whether every subscriber saw every sample.
+// Pass --rt to run the loop SCHED_FIFO as the daemon does with --rt.
+#include <errno.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include "api.h"
+#include "control.h"
+#include "hal.h"
+#include "histogram.h"
+
+#define BENCH_SOCKET "/tmp/api_bench.sock"
+#define BENCH_PERIOD_MS 10
+#define BENCH_WARMUP_TICKS 100 // Clients connect and subscribe meanwhile
+#define BENCH_TICKS 1000
+#define BENCH_POLLERS 4        // Clients sending status batches nonstop
+#define BENCH_BATCH 8          // Status requests per batch
+
+// Filled in by the client processes
+struct client_totals
+{
+    _Atomic unsigned long samples;
+    _Atomic unsigned long missed;    // Gaps in the tick numbers
+    _Atomic unsigned long requests;
+};
+
+static struct drier drier;
+static struct client_totals *totals;
+static struct histogram jitter;
+static struct histogram api_time;
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int connect_client(void)
+{
+    struct sockaddr_un addr = {.sun_family = AF_UNIX, .sun_path = BENCH_SOCKET};
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    while (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        usleep(1000);
+    }
+    return fd;
+}
+
+static int read_exactly(int fd, void *data, size_t length)
+{
+    for (size_t done = 0; done < length;)
+    {
+        ssize_t n = read(fd, (char *)data + done, length - done);
+        if (n <= 0)
+        {
+            return -1;
+        }
+        done += n;
+    }
+    return 0;
+}
+
+// Subscribe to every tick and count samples until the server closes
+static void subscriber(void)
+{
+    int fd = connect_client();
+    struct api_frame frame = {sizeof(struct api_subscribe), API_SUBSCRIBE, 1};
+    struct api_subscribe subscribe = {1};
+    unsigned char request[sizeof(frame) + sizeof(subscribe)];
+    memcpy(request, &frame, sizeof(frame));
+    memcpy(request + sizeof(frame), &subscribe, sizeof(subscribe));
+    if (write(fd, request, sizeof(request)) != sizeof(request))
+    {
+        _exit(1);
+    }
+
+    unsigned char payload[API_MAX_PAYLOAD];
+    uint32_t last_tick = 0;
+    while (read_exactly(fd, &frame, sizeof(frame)) == 0 && read_exactly(fd, payload, frame.length) == 0)
+    {
+        if (frame.type != API_SAMPLE)
+        {
+            continue;
+        }
+        struct api_status status;
+        memcpy(&status, payload, sizeof(status));
+        if (last_tick && status.tick != last_tick + 1)
+        {
+            atomic_fetch_add(&totals->missed, status.tick - last_tick - 1);
+        }
+        last_tick = status.tick;
+        atomic_fetch_add(&totals->samples, 1);
+    }
+    _exit(0);
+}
+
+// Batches of status requests back to back until the server closes
+static void poller(void)
+{
+    int fd = connect_client();
+    unsigned char request[sizeof(struct api_frame) * (BENCH_BATCH + 1)];
+    struct api_frame batch = {sizeof(struct api_frame) * BENCH_BATCH, API_BATCH, 1};
+    memcpy(request, &batch, sizeof(batch));
+    for (int i = 1; i <= BENCH_BATCH; i++)
+    {
+        struct api_frame status = {0, API_GET_STATUS, (uint8_t)i};
+        memcpy(request + i * sizeof(status), &status, sizeof(status));
+    }
+
+    unsigned char payload[API_MAX_PAYLOAD];
+    struct api_frame frame;
+    while (write(fd, request, sizeof(request)) == sizeof(request) && read_exactly(fd, &frame, sizeof(frame)) == 0 &&
+           read_exactly(fd, payload, frame.length) == 0)
+    {
+        atomic_fetch_add(&totals->requests, BENCH_BATCH);
+        usleep(1000);
+    }
+    _exit(0);
+}
+
+static void run(int subscribers, int pollers)
+{
+    memset(&jitter, 0, sizeof(jitter));
+    memset(&api_time, 0, sizeof(api_time));
+    memset(totals, 0, sizeof(*totals));
+    struct api_stats before = api_stats;
+
+    int api_fd = api_start(BENCH_SOCKET, &drier, NULL);
+    int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    int epoll_fd = epoll_create1(0);
+    struct itimerspec spec = {{0, BENCH_PERIOD_MS * 1000000L}, {0, BENCH_PERIOD_MS * 1000000L}};
+    struct epoll_event ev = {.events = EPOLLIN, .data.fd = timer_fd};
+    timerfd_settime(timer_fd, 0, &spec, NULL);
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev);
+    ev.data.fd = api_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, api_fd, &ev);
+
+    fflush(stdout);
+    for (int i = 0; i < subscribers + pollers; i++)
+    {
+        if (fork() == 0)
+        {
+            close(epoll_fd);
+            i < subscribers ? subscriber() : poller();
+        }
+    }
+
+    int ticks = 0;
+    int64_t last_tick = 0;
+    while (ticks < BENCH_WARMUP_TICKS + BENCH_TICKS)
+    {
+        struct epoll_event events[8];
+        int count = epoll_wait(epoll_fd, events, 8, -1);
+        for (int i = 0; i < count; i++)
+        {
+            uint64_t expirations;
+            if (events[i].data.fd == timer_fd && read(timer_fd, &expirations, sizeof(expirations)) > 0)
+            {
+                int64_t tick_start = now_ns();
+                if (ticks++ > BENCH_WARMUP_TICKS)
+                {
+                    int64_t nominal = (int64_t)expirations * BENCH_PERIOD_MS * 1000000LL;
+                    histogram_record(&jitter, llabs(tick_start - last_tick - nominal));
+                }
+                last_tick = tick_start;
+                control_run_timers(&drier);
+                api_publish();
+                histogram_record(&api_time, now_ns() - tick_start);
+            }
+            else if (events[i].data.fd == api_fd)
+            {
+                int64_t start = now_ns();
+                api_service();
+                histogram_record(&api_time, now_ns() - start);
+            }
+        }
+    }
+
+    api_stop();
+    close(epoll_fd);
+    close(timer_fd);
+    while (wait(NULL) > 0)
+    {
+    }
+
+    printf("%6d %7d %10.1f %10.1f %10.1f %11.1f %10lu %8lu %8lu %9lu\n", subscribers, pollers,
+           histogram_percentile(&jitter, 0.50) / 1e3, histogram_percentile(&jitter, 0.99) / 1e3,
+           atomic_load(&jitter.max) / 1e3, histogram_percentile(&api_time, 0.99) / 1e3,
+           atomic_load(&totals->samples), atomic_load(&totals->missed), api_stats.dropped - before.dropped,
+           atomic_load(&totals->requests));
+}
+
+int main(int argc, char **argv)
+{
+    totals = mmap(NULL, sizeof(*totals), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    hal_init();
+    control_init(&drier, OUTPUT_SWITCHED);
+
+    if (argc > 1 && strcmp(argv[1], "--rt") == 0)
+    {
+        struct sched_param param = {.sched_priority = 50};
+        if (sched_setscheduler(0, SCHED_FIFO, &param) < 0)
+        {
+            perror("SCHED_FIFO");
+        }
+    }
+
+    printf("%d ms ticks, %d measured per row\n", BENCH_PERIOD_MS, BENCH_TICKS);
+    printf("%6s %7s %10s %10s %10s %11s %10s %8s %8s %9s\n", "subs", "pollers", "jitter p50", "p99 us",
+           "max us", "api p99 us", "samples", "missed", "dropped", "requests");
+    run(0, 0);
+    run(12, 0);
+    run(48, 0);
+    run(48, BENCH_POLLERS);
+    run(API_MAX_CLIENTS - BENCH_POLLERS, BENCH_POLLERS);
+    hal_terminate();
+    return 0;
+}
@@ -0,0 +1,114 @@
+// Compares on/off and PID control on the simulated drier: rise time,
+// overshoot and steady-state ripple of the true chamber temperature for a
+// step from ambient to each setpoint.
+#include <stdio.h>
+#include "control.h"
+#include "hal.h"
+#include "hal_sim.h"
+
+#define BENCH_DURATION 14400 // Four simulated hours per run
+#define RIPPLE_WINDOW 3600   // Ripple is measured over the last hour
+
+static const float setpoints[] = {45.0, 60.0, 75.0};
+
+// PID output stages compared against on/off
+static const struct
+{
+    const char *name;
+    int mode;
+} outputs[] = {
+    {"pid", OUTPUT_SWITCHED},
+    {"pid/pwm", OUTPUT_PWM},
+    {"pid/window", OUTPUT_TIME_PROPORTIONAL},
+};
+
+// Struct definitions
+struct step_response
+{
+    double rise_time; // 10% to 90% of the step
+    float overshoot;
+    float ripple;     // Peak-to-peak in the final window
+};
+
+static struct drier drier;
+static struct pid tuned; // Gains from the last autotune run
+
+static struct step_response run(int mode, int output, float setpoint)
+{
+    hal_init();
+    hal_sim_use_virtual_clock(0.0);
+    control_init(&drier, output);
+    drier.pid_gains_path = NULL;
+    drier.control_mode = mode;
+    drier.desired_temp = setpoint;
+    if (mode == CONTROL_PID)
+    {
+        pid_init(&drier.pid, tuned.kp, tuned.ki, tuned.kd);
+    }
+
+    float start = hal_sim_chamber_temp(HEAT_SENSOR_CHANNEL);
+    float low = start + 0.1f * (setpoint - start);
+    float high = start + 0.9f * (setpoint - start);
+    double t_low = -1, t_high = -1;
+    float peak = start, window_min = MAX_TEMP, window_max = 0;
+
+    while (hal_time() < BENCH_DURATION)
+    {
+        double tick_start = hal_time();
+        control_heater(&drier, read_temperature(&drier));
+        heater_sleep_until(&drier, tick_start + SAMPLE_INTERVAL / 1000.0);
+
+        float actual = hal_sim_chamber_temp(HEAT_SENSOR_CHANNEL);
+        double now = hal_time();
+        if (t_low < 0 && actual >= low)
+        {
+            t_low = now;
+        }
+        if (t_high < 0 && actual >= high)
+        {
+            t_high = now;
+        }
+        peak = actual > peak ? actual : peak;
+        if (now >= BENCH_DURATION - RIPPLE_WINDOW)
+        {
+            window_min = actual < window_min ? actual : window_min;
+            window_max = actual > window_max ? actual : window_max;
+        }
+    }
+
+    struct step_response result = {
+        .rise_time = (t_low >= 0 && t_high >= 0) ? t_high - t_low : -1,
+        .overshoot = peak > setpoint ? peak - setpoint : 0,
+        .ripple = window_max - window_min,
+    };
+    return result;
+}
+
+int main(void)
+{
+    printf("%-10s %8s %12s %12s %12s\n", "mode", "setpoint", "rise (s)", "overshoot", "ripple p-p");
+    for (unsigned i = 0; i < sizeof(setpoints) / sizeof(setpoints[0]); i++)
+    {
+        // Tune once at this setpoint, then run PID from a cold start
+        run(CONTROL_AUTOTUNE, OUTPUT_SWITCHED, setpoints[i]);
+        int converged = drier.control_mode == CONTROL_PID;
+        tuned = drier.pid;
+
+        struct step_response bang = run(CONTROL_BANG_BANG, OUTPUT_SWITCHED, setpoints[i]);
+        printf("%-10s %8.1f %12.0f %12.2f %12.2f\n", "on/off", setpoints[i],
+               bang.rise_time, bang.overshoot, bang.ripple);
+
+        if (!converged)
+        {
+            printf("%-10s %8.1f autotune did not converge\n", "pid", setpoints[i]);
+            continue;
+        }
+        for (unsigned j = 0; j < sizeof(outputs) / sizeof(outputs[0]); j++)
+        {
+            struct step_response pid = run(CONTROL_PID, outputs[j].mode, setpoints[i]);
+            printf("%-10s %8.1f %12.0f %12.2f %12.2f\n", outputs[j].name, setpoints[i],
+                   pid.rise_time, pid.overshoot, pid.ripple);
+        }
+    }
+    return 0;
+}
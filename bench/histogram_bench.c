@@ -0,0 +1,90 @@
+// Cost and accuracy of the latency histograms. Times histogram_record()
+// alone and latency_mark() with its clock read, then checks the p50, p99
+// and p99.9 the histogram reports against exact percentiles of the same
+// heavy-tailed samples.
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "histogram.h"
+#include "latency.h"
+#include "sampler.h"
+
+#define BENCH_RECORDS 10000000
+#define BENCH_SAMPLES 1000000
+
+static struct histogram histogram;
+static int64_t samples[BENCH_SAMPLES];
+
+static int compare_i64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Log-normal around 50 us with the occasional multi-millisecond stall,
+// roughly what a control tick looks like
+static int64_t draw(void)
+{
+    double u1 = (rand() + 1.0) / (RAND_MAX + 2.0), u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double normal = sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+    double value = 50000 * exp(0.5 * normal);
+    if (rand() % 1000 == 0)
+    {
+        value *= 100;
+    }
+    return (int64_t)value;
+}
+
+int main(void)
+{
+    for (int i = 0; i < BENCH_SAMPLES; i++)
+    {
+        samples[i] = draw();
+    }
+
+    int64_t start = monotonic_ns();
+    for (int i = 0; i < BENCH_RECORDS; i++)
+    {
+        histogram_record(&histogram, samples[i % BENCH_SAMPLES]);
+    }
+    double record_ns = (double)(monotonic_ns() - start) / BENCH_RECORDS;
+
+    int64_t t = monotonic_ns();
+    start = t;
+    for (int i = 0; i < BENCH_RECORDS; i++)
+    {
+        t = latency_mark(LATENCY_CONTROL, t);
+    }
+    double mark_ns = (double)(monotonic_ns() - start) / BENCH_RECORDS;
+
+    printf("histogram_record %.1f ns, latency_mark %.1f ns, %zu bytes per histogram\n", record_ns, mark_ns,
+           sizeof(struct histogram));
+
+    // Accuracy on exactly the samples recorded
+    static struct histogram exact_run;
+    for (int i = 0; i < BENCH_SAMPLES; i++)
+    {
+        histogram_record(&exact_run, samples[i]);
+    }
+    qsort(samples, BENCH_SAMPLES, sizeof(samples[0]), compare_i64);
+
+    static const double fractions[] = {0.5, 0.99, 0.999};
+    int failures = 0;
+    printf("%-8s %12s %12s %8s\n", "pct", "exact us", "hist us", "error");
+    for (int i = 0; i < 3; i++)
+    {
+        int64_t exact = samples[(int)(fractions[i] * BENCH_SAMPLES + 0.5) - 1];
+        int64_t reported = histogram_percentile(&exact_run, fractions[i]);
+        double error = (double)(reported - exact) / exact;
+        printf("p%-7g %12.1f %12.1f %7.2f%%\n", fractions[i] * 100, exact / 1e3, reported / 1e3, error * 100);
+        if (error < 0 || error > 1.0 / HISTOGRAM_SUB_BUCKETS)
+        {
+            failures++;
+        }
+    }
+    if (atomic_load(&exact_run.max) != (uint64_t)samples[BENCH_SAMPLES - 1])
+    {
+        failures++;
+    }
+    return failures ? 1 : 0;
+}
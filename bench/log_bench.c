@@ -0,0 +1,205 @@
+// Cost of logging from the control path when the log device is slow.
+// A status line is logged every 500 us into a FIFO whose reader only
+// drains 512 bytes every 50 ms, standing in for a struggling SD card: first
+// with a synchronous fprintf/fflush, as the loop used to, then through
+// the asynchronous logger. Per-call latency shows which one the control
+// thread waits on. A flood of warnings from one site then checks rate
+// limiting and the summary line, and a burst of output checks rotation.
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "histogram.h"
+#include "log.h"
+
+#define BENCH_LINES 2000
+#define BENCH_PERIOD_US 500
+#define READER_CHUNK 512
+#define READER_PERIOD_MS 50
+#define FLOOD_WARNINGS 100000
+#define ROTATE_LINES 20000 // About 2 MB of status lines
+
+// Struct definitions
+struct slow_reader
+{
+    const char *path;
+    pthread_t thread;
+    volatile int running;
+};
+
+static struct histogram sync_latency, async_latency;
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void sleep_us(long us)
+{
+    struct timespec ts = {us / 1000000, (us % 1000000) * 1000};
+    nanosleep(&ts, NULL);
+}
+
+static void *reader_main(void *arg)
+{
+    struct slow_reader *reader = arg;
+    int fd = open(reader->path, O_RDONLY);
+    char buffer[READER_CHUNK];
+    while (fd >= 0 && read(fd, buffer, sizeof(buffer)) > 0)
+    {
+        if (reader->running)
+        {
+            sleep_us(READER_PERIOD_MS * 1000);
+        }
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    return NULL;
+}
+
+static void reader_start(struct slow_reader *reader, const char *path)
+{
+    reader->path = path;
+    reader->running = 1;
+    mkfifo(path, 0600);
+    pthread_create(&reader->thread, NULL, reader_main, reader);
+}
+
+// Let the reader drain at full speed so the writer can finish
+static void reader_stop(struct slow_reader *reader)
+{
+    reader->running = 0;
+    pthread_join(reader->thread, NULL);
+    unlink(reader->path);
+}
+
+static void report(const char *name, const struct histogram *h)
+{
+    printf("%-6s %10.2f %10.2f %10.2f %12.2f\n", name, atomic_load(&h->sum) / 1e3 / atomic_load(&h->total),
+           histogram_percentile(h, 0.50) / 1e3, histogram_percentile(h, 0.99) / 1e3, atomic_load(&h->max) / 1e3);
+}
+
+// Matching lines across the log and its rotated copies
+static int count_lines_with(const char *path, const char *needle)
+{
+    int count = 0;
+    for (int i = 0; i <= LOG_KEEP_FILES; i++)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), i ? "%s.%d" : "%s", path, i);
+        FILE *file = fopen(name, "r");
+        char line[512];
+        while (file && fgets(line, sizeof(line), file))
+        {
+            count += strstr(line, needle) != NULL;
+        }
+        if (file)
+        {
+            fclose(file);
+        }
+    }
+    return count;
+}
+
+int main(void)
+{
+    int failures = 0;
+    struct slow_reader reader;
+
+    // Synchronous, as the control loop used to print
+    reader_start(&reader, "/tmp/log_bench.sync");
+    FILE *sink = fopen("/tmp/log_bench.sync", "w");
+    for (int i = 0; i < BENCH_LINES; i++)
+    {
+        int64_t start = now_ns();
+        fprintf(sink, "Current: %.1f°C (variance %.3f), Desired: %.1f°C\n", 20.0 + i * 0.01, 0.004, 60.0);
+        fflush(sink);
+        histogram_record(&sync_latency, now_ns() - start);
+        sleep_us(BENCH_PERIOD_US);
+    }
+    fclose(sink);
+    reader_stop(&reader);
+
+    // Same lines through the logger
+    reader_start(&reader, "/tmp/log_bench.async");
+    log_open("/tmp/log_bench.async");
+    log_start();
+    for (int i = 0; i < BENCH_LINES; i++)
+    {
+        int64_t start = now_ns();
+        log_info("Current: %.1f°C (variance %.3f), Desired: %.1f°C", 20.0 + i * 0.01, 0.004, 60.0);
+        histogram_record(&async_latency, now_ns() - start);
+        sleep_us(BENCH_PERIOD_US);
+    }
+    reader.running = 0;
+    log_stop();
+
+    // Moving the logger to the next file closes the FIFO for the reader
+    const char *path = "/tmp/log_bench.log";
+    char rotated[64];
+    for (int i = LOG_KEEP_FILES; i >= 1; i--)
+    {
+        snprintf(rotated, sizeof(rotated), "%s.%d", path, i);
+        unlink(rotated);
+    }
+    unlink(path);
+    log_open(path);
+    reader_stop(&reader);
+
+    printf("%d lines every %d us into a reader draining %d bytes per %d ms\n", BENCH_LINES, BENCH_PERIOD_US,
+           READER_CHUNK, READER_PERIOD_MS);
+    printf("%-6s %10s %10s %10s %12s\n", "mode", "mean us", "p50 us", "p99 us", "max us");
+    report("sync", &sync_latency);
+    report("async", &async_latency);
+    printf("async: %lu record(s) dropped on a full queue, %lu write(s) for %lu bytes\n",
+           atomic_load(&log_stats.dropped), atomic_load(&log_stats.writes), atomic_load(&log_stats.bytes));
+
+    // A flaky sensor: one site flooding warnings, then quiet
+    log_start();
+    unsigned long suppressed_before = atomic_load(&log_stats.suppressed);
+    for (int i = 0; i < FLOOD_WARNINGS; i++)
+    {
+        log_warn("Invalid voltage reading %.3f V on channel %d", 3.3 - (i % 7) * 0.001, 0);
+    }
+    unsigned long suppressed = atomic_load(&log_stats.suppressed) - suppressed_before;
+    sleep_us((LOG_RATE_WINDOW_S * 1000 + 3 * LOG_FLUSH_MS) * 1000L);
+
+    // Enough output to roll the file over
+    for (int i = 0; i < ROTATE_LINES; i++)
+    {
+        log_info("Current: %.1f°C (variance %.3f), Desired: %.1f°C, padding the line out to about a hundred bytes",
+                 20.0, 0.004, 60.0);
+        if (i % (LOG_QUEUE_SIZE / 2) == 0)
+        {
+            sleep_us(LOG_FLUSH_MS * 1000 * 3 / 2);
+        }
+    }
+    log_stop();
+
+    int shown = count_lines_with(path, "Invalid voltage");
+    int summaries = count_lines_with(path, "more in last");
+    struct stat st;
+    int rotated_ok = stat(rotated, &st) == 0 && atomic_load(&log_stats.rotations) > 0;
+    printf("flood: %d warnings, %lu suppressed, %d line(s) written, %d summary line(s); rotations: %lu\n",
+           FLOOD_WARNINGS, suppressed, shown, summaries, atomic_load(&log_stats.rotations));
+    if (suppressed != FLOOD_WARNINGS - LOG_RATE_BURST || summaries != 1 || shown != LOG_RATE_BURST + 1 ||
+        !rotated_ok)
+    {
+        failures++;
+    }
+    for (int i = 1; i <= LOG_KEEP_FILES; i++)
+    {
+        snprintf(rotated, sizeof(rotated), "%s.%d", path, i);
+        unlink(rotated);
+    }
+    unlink(path);
+    return failures ? 1 : 0;
+}
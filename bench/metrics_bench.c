@@ -0,0 +1,236 @@
+// Load test for the metrics listener. Runs the daemon's loop shape, a
+// periodic timerfd plus the metrics descriptor on one epoll, with a
+// control tick every BENCH_PERIOD_MS. Scrapers are separate processes
+// fetching /metrics back to back. Reports what formatting one response
+// costs, the tick period's jitter with and without scrapers, the loop
+// time spent serving them, and how far the heap moved across all the
+// scrapes (it should not move at all).
+// Pass --rt to run the loop SCHED_FIFO as the daemon does with --rt.
+#include <malloc.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/wait.h>
+#include "control.h"
+#include "hal.h"
+#include "histogram.h"
+#include "latency.h"
+#include "metrics.h"
+
+#define BENCH_ADDRESS "127.0.0.1:19464"
+#define BENCH_PORT 19464
+#define BENCH_PERIOD_MS 10
+#define BENCH_WARMUP_TICKS 100
+#define BENCH_TICKS 1000
+#define BENCH_FORMATS 10000    // Timed metrics_format calls
+
+// Filled in by the scraper processes
+struct scraper_totals
+{
+    _Atomic unsigned long scrapes;
+    _Atomic unsigned long failed;    // Refused, evicted, or not a complete 200
+    _Atomic int serving;             // Set by the loop once it listens
+    _Atomic int done;                // and once the run is over
+};
+
+static struct drier drier;
+static struct scraper_totals *totals;
+static struct histogram jitter;
+static struct histogram metrics_time;
+static char body[METRICS_RESPONSE_SIZE];
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// One GET /metrics; returns 0 for a complete 200 response
+static int scrape(char *response, size_t size)
+{
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons(BENCH_PORT)};
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    static const char request[] = "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    size_t done = 0;
+    if (write(fd, request, sizeof(request) - 1) == sizeof(request) - 1)
+    {
+        ssize_t n;
+        while (done < size - 1 && (n = read(fd, response + done, size - 1 - done)) > 0)
+        {
+            done += n;
+        }
+    }
+    close(fd);
+    response[done] = '\0';
+    char *length = strstr(response, "Content-Length: ");
+    char *start = strstr(response, "\r\n\r\n");
+    if (strncmp(response, "HTTP/1.1 200 ", 13) != 0 || !length || !start ||
+        (size_t)atol(length + 16) != done - (start + 4 - response))
+    {
+        return -1;
+    }
+    return 0;
+}
+
+// Scrape back to back until the run is over. Scrapers are forked before
+// the listener opens so they do not inherit it.
+static void scraper(void)
+{
+    static char response[METRICS_RESPONSE_SIZE + 1];
+    while (!atomic_load(&totals->serving))
+    {
+        usleep(1000);
+    }
+    while (!atomic_load(&totals->done))
+    {
+        if (scrape(response, sizeof(response)) == 0)
+        {
+            atomic_fetch_add(&totals->scrapes, 1);
+        }
+        else
+        {
+            atomic_fetch_add(&totals->failed, 1);
+        }
+    }
+    _exit(0);
+}
+
+static void run(int scrapers)
+{
+    memset(&jitter, 0, sizeof(jitter));
+    memset(&metrics_time, 0, sizeof(metrics_time));
+    memset(totals, 0, sizeof(*totals));
+    struct metrics_stats before = metrics_stats;
+
+    fflush(stdout);
+    for (int i = 0; i < scrapers; i++)
+    {
+        if (fork() == 0)
+        {
+            scraper();
+        }
+    }
+
+    int metrics_fd = metrics_start(BENCH_ADDRESS, &drier, NULL);
+    int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    int epoll_fd = epoll_create1(0);
+    struct itimerspec spec = {{0, BENCH_PERIOD_MS * 1000000L}, {0, BENCH_PERIOD_MS * 1000000L}};
+    struct epoll_event ev = {.events = EPOLLIN, .data.fd = timer_fd};
+    timerfd_settime(timer_fd, 0, &spec, NULL);
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev);
+    ev.data.fd = metrics_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, metrics_fd, &ev);
+    atomic_store(&totals->serving, 1);
+
+    size_t heap_before = 0;
+    int ticks = 0;
+    int64_t last_tick = 0;
+    while (ticks < BENCH_WARMUP_TICKS + BENCH_TICKS)
+    {
+        struct epoll_event events[8];
+        int count = epoll_wait(epoll_fd, events, 8, -1);
+        for (int i = 0; i < count; i++)
+        {
+            uint64_t expirations;
+            if (events[i].data.fd == timer_fd && read(timer_fd, &expirations, sizeof(expirations)) > 0)
+            {
+                int64_t tick_start = now_ns();
+                if (ticks++ > BENCH_WARMUP_TICKS)
+                {
+                    int64_t nominal = (int64_t)expirations * BENCH_PERIOD_MS * 1000000LL;
+                    histogram_record(&jitter, llabs(tick_start - last_tick - nominal));
+                }
+                else if (ticks == BENCH_WARMUP_TICKS)
+                {
+                    heap_before = mallinfo2().uordblks;
+                }
+                last_tick = tick_start;
+                control_run_timers(&drier);
+                latency_mark(LATENCY_TICK, tick_start);
+            }
+            else if (events[i].data.fd == metrics_fd)
+            {
+                int64_t start = now_ns();
+                metrics_service();
+                histogram_record(&metrics_time, now_ns() - start);
+            }
+        }
+    }
+    long heap_moved = (long)(mallinfo2().uordblks - heap_before);
+
+    atomic_store(&totals->done, 1);
+    metrics_stop();
+    close(epoll_fd);
+    close(timer_fd);
+    while (wait(NULL) > 0)
+    {
+    }
+
+    printf("%8d %10.1f %10.1f %10.1f %14.1f %9lu %8lu %8lu %10ld\n", scrapers,
+           histogram_percentile(&jitter, 0.50) / 1e3, histogram_percentile(&jitter, 0.99) / 1e3,
+           atomic_load(&jitter.max) / 1e3, histogram_percentile(&metrics_time, 0.99) / 1e3,
+           atomic_load(&totals->scrapes), atomic_load(&totals->failed),
+           metrics_stats.refused - before.refused, heap_moved);
+}
+
+int main(int argc, char **argv)
+{
+    totals = mmap(NULL, sizeof(*totals), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    hal_init();
+    control_init(&drier, OUTPUT_SWITCHED);
+
+    if (argc > 1 && strcmp(argv[1], "--rt") == 0)
+    {
+        struct sched_param param = {.sched_priority = 50};
+        if (sched_setscheduler(0, SCHED_FIFO, &param) < 0)
+        {
+            perror("SCHED_FIFO");
+        }
+    }
+
+    // Formatting alone, with every phase histogram populated
+    for (int phase = 0; phase < LATENCY_PHASES; phase++)
+    {
+        for (int i = 0; i < 1000; i++)
+        {
+            latency_mark(phase, now_ns() - (int64_t)(i % 100) * 50000);
+        }
+    }
+    int size = 0;
+    size_t heap_before = mallinfo2().uordblks;
+    int64_t start = now_ns();
+    for (int i = 0; i < BENCH_FORMATS; i++)
+    {
+        size = metrics_format(body, sizeof(body), &drier, NULL);
+    }
+    double format_us = (now_ns() - start) / 1e3 / BENCH_FORMATS;
+    printf("metrics_format: %d byte body in %.1f us, heap moved %ld bytes over %d calls\n\n", size, format_us,
+           (long)(mallinfo2().uordblks - heap_before), BENCH_FORMATS);
+
+    printf("%d ms ticks, %d measured per row\n", BENCH_PERIOD_MS, BENCH_TICKS);
+    printf("%8s %10s %10s %10s %14s %9s %8s %8s %10s\n", "scrapers", "jitter p50", "p99 us", "max us",
+           "metrics p99 us", "scrapes", "failed", "refused", "heap bytes");
+    run(0);
+    run(1);
+    run(METRICS_MAX_CONNECTIONS);
+    run(METRICS_MAX_CONNECTIONS * 4);
+    hal_terminate();
+    return 0;
+}
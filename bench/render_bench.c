@@ -0,0 +1,215 @@
+// Cost of the TUI renderer, driven through a pseudo-terminal with the
+// simulated sensor on the virtual clock. The bench stands in for the
+// control thread, then takes a snapshot and calls the interface's own
+// draw_interface()/update_values() the way its main loop does, over a
+// scripted session: steady state, a timer countdown, a setpoint change
+// and a series of SIGWINCH resizes. Bytes and write syscalls come from
+// the rendering thread's /proc I/O counters; frame time covers composing
+// the frame and writing it out.
+//
+// Pass --frames to also print one line per frame.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <pty.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include "control.h"
+#include "countdown.h"
+#include "hal.h"
+#include "hal_sim.h"
+#include "sampler.h"
+#include "tui.h"
+
+#define BENCH_FRAME_SECONDS 0.5 // The interface redraws every 0.5 s
+#define BENCH_MAX_FRAMES 1024
+
+// Struct definitions
+struct phase
+{
+    const char *name;
+    int frames;
+    float setpoint;     // Negative keeps the current one
+    int timer_seconds;  // Starts a countdown when positive
+    int resize_every;   // Resize the pty every N frames, 0 never
+};
+
+struct io_counters
+{
+    unsigned long bytes;
+    unsigned long writes;
+};
+
+static const struct phase phases[] = {
+    {"steady", 120, -1, 0, 0},
+    {"countdown", 120, -1, 60, 0},
+    {"setpoint", 240, 60.0, 0, 0},
+    {"resize", 80, -1, 0, 10},
+};
+
+static const struct winsize sizes[] = {
+    {24, 80, 0, 0},
+    {40, 120, 0, 0},
+    {30, 100, 0, 0},
+    {50, 160, 0, 0},
+};
+
+static int master_fd;
+static FILE *report;
+static int print_frames = 0;
+
+// Keep the pty drained so the interface never blocks on a full buffer
+static void *drain(void *arg)
+{
+    char buffer[65536];
+    (void)arg;
+    while (read(master_fd, buffer, sizeof(buffer)) > 0)
+    {
+    }
+    return NULL;
+}
+
+static void read_io(struct io_counters *io)
+{
+    char line[128];
+    FILE *file = fopen("/proc/thread-self/io", "r");
+    io->bytes = io->writes = 0;
+    if (!file)
+    {
+        return;
+    }
+    while (fgets(line, sizeof(line), file))
+    {
+        sscanf(line, "wchar: %lu", &io->bytes);
+        sscanf(line, "syscw: %lu", &io->writes);
+    }
+    fclose(file);
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv)
+{
+    int slave_fd;
+    struct winsize size = sizes[0];
+
+    print_frames = argc > 1 && strcmp(argv[1], "--frames") == 0;
+    if (openpty(&master_fd, &slave_fd, NULL, NULL, &size) < 0)
+    {
+        perror("openpty");
+        return 1;
+    }
+
+    // The interface writes to stdout, which becomes the pty from here on
+    report = fdopen(dup(STDOUT_FILENO), "w");
+    dup2(slave_fd, STDOUT_FILENO);
+    pthread_t reader;
+    pthread_create(&reader, NULL, drain, NULL);
+
+    hal_init();
+    hal_sim_use_virtual_clock(0.0);
+    control_init(&drier, OUTPUT_SWITCHED);
+    signal(SIGWINCH, window_change_handler);
+
+    fprintf(report, "%-10s %7s %11s %11s %10s %10s\n",
+            "phase", "frames", "bytes/frm", "writes/frm", "p50 us", "p99 us");
+
+    static double frame_ns[BENCH_MAX_FRAMES];
+    struct tui_snapshot last = {-1, -1, -1, 0, 0};
+    int redraw = 1;
+    int resizes = 0;
+
+    for (size_t p = 0; p < sizeof(phases) / sizeof(phases[0]); p++)
+    {
+        const struct phase *phase = &phases[p];
+        struct io_counters start, end;
+        unsigned long frame_bytes = 0, frame_writes = 0;
+
+        if (phase->setpoint >= 0)
+        {
+            drier.desired_temp = phase->setpoint;
+        }
+        if (phase->timer_seconds > 0)
+        {
+            start_drying(phase->timer_seconds);
+        }
+
+        for (int f = 0; f < phase->frames; f++)
+        {
+            if (phase->resize_every && f % phase->resize_every == 0)
+            {
+                size = sizes[++resizes % (sizeof(sizes) / sizeof(sizes[0]))];
+                ioctl(master_fd, TIOCSWINSZ, &size);
+                // The pty is not our controlling terminal, so deliver it ourselves
+                raise(SIGWINCH);
+                redraw = 1;
+            }
+
+            // What the control thread does on a tick
+            float current_temp = read_temperature(&drier);
+            sample_ring_publish(&drier.samples, monotonic_ns(), current_temp, 0);
+            control_heater(&drier, current_temp);
+            heater_service(&drier);
+            control_run_timers(&drier);
+            int ticked = display_due;
+            display_due = 0;
+
+            // Same decisions as the interface's main loop
+            read_io(&start);
+            double begin = now_ns();
+            struct tui_snapshot now;
+            take_snapshot(&now);
+            if (redraw)
+            {
+                draw_interface(&now);
+                redraw = 0;
+                window_changed = 0;
+            }
+            else if (now.current_temp != last.current_temp || now.desired_temp != last.desired_temp ||
+                     now.is_heating != last.is_heating)
+            {
+                update_values(&now);
+            }
+            if (ticked)
+            {
+                update_values(&now);
+            }
+            fflush(stdout);
+            frame_ns[f] = now_ns() - begin;
+            read_io(&end);
+
+            frame_bytes += end.bytes - start.bytes;
+            frame_writes += end.writes - start.writes;
+            if (print_frames)
+            {
+                fprintf(report, "%-10s %7d %11lu %11lu %10.1f\n", phase->name, f,
+                        end.bytes - start.bytes, end.writes - start.writes, frame_ns[f] / 1000);
+            }
+
+            last = now;
+            hal_sim_advance(BENCH_FRAME_SECONDS);
+        }
+
+        qsort(frame_ns, phase->frames, sizeof(frame_ns[0]), compare_double);
+        fprintf(report, "%-10s %7d %11.1f %11.2f %10.1f %10.1f\n", phase->name, phase->frames,
+                (double)frame_bytes / phase->frames, (double)frame_writes / phase->frames,
+                frame_ns[phase->frames / 2] / 1000, frame_ns[phase->frames * 99 / 100] / 1000);
+    }
+
+    fflush(report);
+    return 0;
+}
@@ -0,0 +1,184 @@
+// cyclictest-style wakeup latency under load, with and without the
+// real-time mode. A measuring thread sleeps to absolute deadlines every
+// interval and records how late it woke; meanwhile load threads churn
+// CPU and memory at normal priority, standing in for OctoPrint and a
+// camera stream. The same run is repeated with the measuring thread in
+// SCHED_FIFO, pinned and with memory locked, as the daemon's --rt does.
+//
+// Options: --seconds=N per run (5), --interval=US (1000), --load=N threads
+// (two per CPU), --priority=N (RT_DEFAULT_PRIORITY), --cpu=N (first
+// isolated CPU, if any). SCHED_FIFO needs root or CAP_SYS_NICE; without
+// it the second run is skipped.
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "histogram.h"
+#include "rt.h"
+
+#define LOAD_BUFFER_SIZE (4 * 1024 * 1024) // Larger than the Pi 4's L2
+
+// Struct definitions
+struct run
+{
+    const char *name;
+    int realtime;
+    int failed; // rt_enter() refused
+    struct histogram latency;
+};
+
+static int bench_seconds = 5;
+static int interval_us = 1000;
+static atomic_int load_running = 0;
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Streams through a buffer bigger than the cache and reallocates it now
+// and then, so the measuring thread competes for CPU, cache and the
+// allocator
+static void *load_main(void *arg)
+{
+    (void)arg;
+    unsigned long sum = 0;
+    while (atomic_load(&load_running))
+    {
+        unsigned char *buffer = malloc(LOAD_BUFFER_SIZE);
+        if (!buffer)
+        {
+            continue;
+        }
+        for (int pass = 0; pass < 8 && atomic_load(&load_running); pass++)
+        {
+            memset(buffer, pass, LOAD_BUFFER_SIZE);
+            for (size_t i = 0; i < LOAD_BUFFER_SIZE; i += 64)
+            {
+                sum += buffer[i];
+            }
+        }
+        free(buffer);
+    }
+    return (void *)sum;
+}
+
+static void *measure_main(void *arg)
+{
+    struct run *run = arg;
+    if (run->realtime && rt_enter() < 0)
+    {
+        run->failed = 1;
+        return NULL;
+    }
+
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    int64_t end = now_ns() + bench_seconds * 1000000000LL;
+    while (now_ns() < end)
+    {
+        next.tv_nsec += interval_us * 1000L;
+        while (next.tv_nsec >= 1000000000L)
+        {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+        int64_t due = (int64_t)next.tv_sec * 1000000000LL + next.tv_nsec;
+        histogram_record(&run->latency, now_ns() - due);
+    }
+    return NULL;
+}
+
+static void run_under_load(struct run *run, int load_threads)
+{
+    pthread_t loads[load_threads];
+    atomic_store(&load_running, 1);
+    for (int i = 0; i < load_threads; i++)
+    {
+        pthread_create(&loads[i], NULL, load_main, NULL);
+    }
+
+    pthread_t measure;
+    pthread_create(&measure, NULL, measure_main, run);
+    pthread_join(measure, NULL);
+
+    atomic_store(&load_running, 0);
+    for (int i = 0; i < load_threads; i++)
+    {
+        pthread_join(loads[i], NULL);
+    }
+}
+
+static void report(const struct run *run)
+{
+    if (run->failed)
+    {
+        printf("%-8s skipped: real-time scheduling not permitted\n", run->name);
+        return;
+    }
+    const struct histogram *h = &run->latency;
+    printf("%-8s %8llu %10.1f %10.1f %10.1f %10.1f %10.1f\n", run->name,
+           (unsigned long long)atomic_load(&h->total), atomic_load(&h->sum) / 1e3 / atomic_load(&h->total),
+           histogram_percentile(h, 0.50) / 1e3, histogram_percentile(h, 0.99) / 1e3,
+           histogram_percentile(h, 0.999) / 1e3, atomic_load(&h->max) / 1e3);
+}
+
+int main(int argc, char **argv)
+{
+    int load_threads = 2 * (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int priority = RT_DEFAULT_PRIORITY;
+    int cpu = rt_isolated_cpu();
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--seconds=", 10) == 0)
+        {
+            bench_seconds = atoi(argv[i] + 10);
+        }
+        else if (strncmp(argv[i], "--interval=", 11) == 0)
+        {
+            interval_us = atoi(argv[i] + 11);
+        }
+        else if (strncmp(argv[i], "--load=", 7) == 0)
+        {
+            load_threads = atoi(argv[i] + 7);
+        }
+        else if (strncmp(argv[i], "--priority=", 11) == 0)
+        {
+            priority = atoi(argv[i] + 11);
+        }
+        else if (strncmp(argv[i], "--cpu=", 6) == 0)
+        {
+            cpu = atoi(argv[i] + 6);
+        }
+    }
+
+    static struct run normal = {.name = "normal"};
+    static struct run realtime = {.name = "rt", .realtime = 1};
+
+    char pinning[32] = "unpinned";
+    if (cpu >= 0)
+    {
+        snprintf(pinning, sizeof(pinning), "CPU %d", cpu);
+    }
+    printf("%d s per run, %d us interval, %d load thread(s); rt: SCHED_FIFO %d, %s\n", bench_seconds, interval_us,
+           load_threads, priority, pinning);
+
+    // Normal first: memory locking cannot be undone for the second run
+    run_under_load(&normal, load_threads);
+    rt_priority = priority;
+    rt_cpu = cpu;
+    rt_lock_memory();
+    run_under_load(&realtime, load_threads);
+
+    printf("%-8s %8s %10s %10s %10s %10s %10s\n", "mode", "wakeups", "mean us", "p50 us", "p99 us", "p99.9 us",
+           "max us");
+    report(&normal);
+    report(&realtime);
+    return 0;
+}
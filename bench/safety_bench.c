@@ -0,0 +1,117 @@
+// Edge-to-cutoff latency of the over-temperature and lid interlock on the
+// simulated backend. The heater is driven full on, then the thermostat
+// and lid inputs are tripped alternately; each trip must leave the heater
+// pin at zero and keep the control loop from switching it back on until
+// the input clears. Latency is from the edge timestamp to the last heater
+// write, as safety_edge() records it, so it covers alert-thread delivery
+// and the cutoff itself.
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "control.h"
+#include "hal.h"
+#include "hal_sim.h"
+#include "safety.h"
+
+#define BENCH_TRIPS 20000
+#define TRIP_TIMEOUT_NS 1000000000LL // Give up on a trip that never lands
+
+static struct drier drier;
+static uint32_t latencies[BENCH_TRIPS];
+
+static long long now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Spin until the alert thread has handled `trips` cutoffs
+static int wait_for_trips(unsigned long trips)
+{
+    long long give_up = now_ns() + TRIP_TIMEOUT_NS;
+    while (atomic_load(&safety_stats.trips) < trips)
+    {
+        if (now_ns() > give_up)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Spin until `bit` has cleared again
+static int wait_for_clear(int bit)
+{
+    long long give_up = now_ns() + TRIP_TIMEOUT_NS;
+    while (atomic_load(&safety_active) & bit)
+    {
+        if (now_ns() > give_up)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int main(void)
+{
+    hal_init();
+    control_init(&drier, OUTPUT_SWITCHED);
+    if (safety_init() < 0)
+    {
+        fprintf(stderr, "Cannot watch the interlock inputs\n");
+        return 1;
+    }
+
+    int failures = 0;
+    for (int i = 0; i < BENCH_TRIPS; i++)
+    {
+        int pin = (i & 1) ? SAFETY_LID_PIN : SAFETY_THERMOSTAT_PIN;
+        int bit = (i & 1) ? SAFETY_LID_OPEN : SAFETY_OVER_TEMP;
+
+        heater_set_duty(&drier, 1);
+        if (hal_sim_heater_level(TRANSISTOR) != 1.0)
+        {
+            fprintf(stderr, "trip %d: heater did not come back on after the input cleared\n", i);
+            failures++;
+        }
+
+        hal_sim_set_input(pin, SAFETY_ACTIVE_LEVEL);
+        if (wait_for_trips(i + 1) < 0)
+        {
+            fprintf(stderr, "trip %d: no cutoff\n", i);
+            return 1;
+        }
+        latencies[i] = atomic_load(&safety_stats.last_latency_us);
+
+        // Cut, and the control loop cannot turn it back on while tripped
+        heater_set_duty(&drier, 1);
+        if (hal_sim_heater_level(TRANSISTOR) != 0.0)
+        {
+            fprintf(stderr, "trip %d: heater on while the interlock is tripped\n", i);
+            failures++;
+        }
+
+        hal_sim_set_input(pin, !SAFETY_ACTIVE_LEVEL);
+        if (wait_for_clear(bit) < 0)
+        {
+            fprintf(stderr, "trip %d: interlock never cleared\n", i);
+            return 1;
+        }
+    }
+    hal_terminate();
+
+    qsort(latencies, BENCH_TRIPS, sizeof(latencies[0]), compare_u32);
+    printf("%d trips, %d failures\n", BENCH_TRIPS, failures);
+    printf("edge to heater off: p50 %u us, p99 %u us, max %u us, mean %.1f us\n", latencies[BENCH_TRIPS / 2],
+           latencies[BENCH_TRIPS * 99 / 100], latencies[BENCH_TRIPS - 1],
+           (double)atomic_load(&safety_stats.total_latency_us) / BENCH_TRIPS);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,83 @@
+// Temperature chart cost per control tick, drawing incrementally versus
+// redrawing the whole plot, across terminal widths and history spans.
+// Each tick adds a sample, updates the chart and flushes the screen to
+// /dev/null; reported are the time spent on the chart, the time of the
+// whole tick including the flush's diff, and the bytes sent.
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include "sparkline.h"
+
+#define BENCH_TICKS 20000
+#define BENCH_TICK_NS 500000000LL // Control cadence of the TUI
+#define BENCH_HEIGHT 12
+
+static struct sparkline chart;
+static struct screen screen;
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Slow heating ramp with sensor noise, in °C
+static float temperature_at(int tick)
+{
+    return 20 + 40 * (1 - exp(-tick / 3000.0)) + sin(tick * 1.3) * 0.4;
+}
+
+static void run(int cols, int64_t span_ns, int incremental, int fd)
+{
+    screen_init(&screen, BENCH_HEIGHT + 2, cols);
+    sparkline_init(&chart, span_ns, cols - SPARKLINE_AXIS_WIDTH, 0);
+    sparkline_draw(&chart, &screen, 2, 1, BENCH_HEIGHT);
+    screen_flush(&screen, fd);
+
+    unsigned long bytes = screen.bytes_written;
+    int64_t chart_ns = 0;
+    int64_t start = now_ns();
+    for (int tick = 1; tick <= BENCH_TICKS; tick++)
+    {
+        int64_t chart_start = now_ns();
+        int closed = sparkline_add(&chart, tick * BENCH_TICK_NS, temperature_at(tick), 60);
+        if (incremental)
+        {
+            sparkline_update(&chart, &screen, closed);
+        }
+        else
+        {
+            sparkline_draw(&chart, &screen, 2, 1, BENCH_HEIGHT);
+        }
+        chart_ns += now_ns() - chart_start;
+        screen_flush(&screen, fd);
+    }
+    double tick_us = (now_ns() - start) / 1e3 / BENCH_TICKS;
+    double tick_bytes = (double)(screen.bytes_written - bytes) / BENCH_TICKS;
+
+    printf("%6d %8.0f min  %-11s %10.2f %10.2f %12.1f\n", cols, span_ns / 60e9, incremental ? "incremental" : "full",
+           chart_ns / 1e3 / BENCH_TICKS, tick_us, tick_bytes);
+    screen_free(&screen);
+}
+
+int main(void)
+{
+    static const int widths[] = {80, 200, 500};
+    static const int64_t spans[] = {600 * 1000000000LL, 8 * 3600 * 1000000000LL};
+    int fd = open("/dev/null", O_WRONLY);
+
+    printf("%6s %12s  %-11s %10s %10s %12s\n", "cols", "span", "update", "chart us", "tick us", "bytes/tick");
+    for (unsigned w = 0; w < sizeof(widths) / sizeof(widths[0]); w++)
+    {
+        for (unsigned s = 0; s < sizeof(spans) / sizeof(spans[0]); s++)
+        {
+            run(widths[w], spans[s], 1, fd);
+            run(widths[w], spans[s], 0, fd);
+        }
+    }
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,169 @@
+// Telemetry store on a long synthetic history: append cost, file size,
+// and query latency for ranges from ten minutes to six months. Queries
+// are checked against a brute-force pass over the generated samples, and
+// again after reopening the file.
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "telemetry.h"
+
+#define BENCH_PATH "/tmp/telemetry_bench.ts"
+#define BENCH_DAYS 200
+#define BENCH_PERIOD_MS 5000
+#define BENCH_START_MS 1767225600000LL // 2026-01-01
+#define BENCH_POINTS 120
+#define BENCH_QUERY_REPEATS 2000
+#define FAULT_EVERY 10007 // Samples between simulated sensor faults
+
+static struct telemetry_bucket buckets[BENCH_POINTS];
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// A drying run a day: heat to 40-70 °C for eight hours, then cool
+static struct telemetry_sample sample_at(int64_t i)
+{
+    int64_t time_ms = BENCH_START_MS + i * BENCH_PERIOD_MS;
+    double hour = fmod((time_ms - BENCH_START_MS) / 3600000.0, 24.0);
+    double setpoint = hour < 8 ? 40 + (i / 17280) % 4 * 10 : 0;
+    double temperature = 20 + (setpoint > 0 ? (setpoint - 20) * (1 - exp(-hour * 2)) : 25 * exp(-(hour - 8)));
+    temperature += sin(i * 0.7) * 0.3;
+
+    struct telemetry_sample s = {time_ms, temperature, setpoint, setpoint > 0 ? 0.4 : 0, 0};
+    if (i % FAULT_EVERY == FAULT_EVERY - 1)
+    {
+        s.temperature = -1;
+        s.flags |= TELEMETRY_SENSOR_FAULT;
+    }
+    s.flags |= setpoint > 0 ? TELEMETRY_HEATING : 0;
+    return s;
+}
+
+// Brute-force summary of samples [first, last]
+static struct telemetry_bucket brute_force(int64_t first, int64_t last)
+{
+    struct telemetry_bucket b = {.min_temperature = 1e9, .max_temperature = -1e9};
+    double sum = 0;
+    for (int64_t i = first; i <= last; i++)
+    {
+        struct telemetry_sample s = sample_at(i);
+        b.samples++;
+        if (s.flags & TELEMETRY_SENSOR_FAULT)
+        {
+            continue;
+        }
+        b.valid++;
+        sum += s.temperature;
+        b.min_temperature = fminf(b.min_temperature, s.temperature);
+        b.max_temperature = fmaxf(b.max_temperature, s.temperature);
+    }
+    b.mean_temperature = sum / b.valid;
+    return b;
+}
+
+static struct telemetry_bucket combine(int count)
+{
+    struct telemetry_bucket b = {.min_temperature = 1e9, .max_temperature = -1e9};
+    double sum = 0;
+    for (int i = 0; i < count; i++)
+    {
+        b.samples += buckets[i].samples;
+        b.valid += buckets[i].valid;
+        sum += (double)buckets[i].mean_temperature * buckets[i].valid;
+        if (buckets[i].valid)
+        {
+            b.min_temperature = fminf(b.min_temperature, buckets[i].min_temperature);
+            b.max_temperature = fmaxf(b.max_temperature, buckets[i].max_temperature);
+        }
+    }
+    b.mean_temperature = sum / b.valid;
+    return b;
+}
+
+// Query the last `seconds` of history, aligned to 10 min so every tier
+// sees the same samples. Returns 0 if it matches the brute-force pass.
+static int check_range(struct telemetry *t, int64_t samples, int64_t seconds, int timed)
+{
+    int64_t last_ms = BENCH_START_MS + (samples - 1) * BENCH_PERIOD_MS;
+    int64_t from_ms = last_ms - seconds * 1000;
+    from_ms -= from_ms % 600000;
+    int64_t first = (from_ms - BENCH_START_MS + BENCH_PERIOD_MS - 1) / BENCH_PERIOD_MS;
+    if (first < samples - TELEMETRY_RAW_CAPACITY && seconds <= 43200)
+    {
+        // Keep the raw ring's range fully inside what it still holds
+        first = samples - TELEMETRY_RAW_CAPACITY;
+        from_ms = BENCH_START_MS + first * BENCH_PERIOD_MS;
+    }
+
+    int count = 0;
+    int64_t start = now_ns();
+    for (int r = 0; r < (timed ? BENCH_QUERY_REPEATS : 1); r++)
+    {
+        count = telemetry_query(t, from_ms, last_ms, BENCH_POINTS, buckets);
+    }
+    double query_us = (now_ns() - start) / 1e3 / (timed ? BENCH_QUERY_REPEATS : 1);
+
+    struct telemetry_bucket got = combine(count);
+    struct telemetry_bucket want = brute_force(first, samples - 1);
+    int ok = got.samples == want.samples && got.valid == want.valid && got.min_temperature == want.min_temperature &&
+             got.max_temperature == want.max_temperature && fabsf(got.mean_temperature - want.mean_temperature) < 1e-3;
+    if (timed)
+    {
+        int64_t spacing = count > 1 ? (buckets[1].start_ms - buckets[0].start_ms) / 1000 : 0;
+        printf("%10lld s %8d %9lld s %10.2f   %s\n", (long long)seconds, count, (long long)spacing, query_us,
+               ok ? "ok" : "MISMATCH");
+    }
+    return ok ? 0 : 1;
+}
+
+int main(void)
+{
+    static const int64_t ranges[] = {600, 3600, 43200, 86400, 7 * 86400, 30 * 86400, 180 * 86400};
+    int ranges_count = sizeof(ranges) / sizeof(ranges[0]);
+    int64_t samples = (int64_t)BENCH_DAYS * 86400000 / BENCH_PERIOD_MS;
+
+    unlink(BENCH_PATH);
+    struct telemetry t;
+    if (telemetry_open(&t, BENCH_PATH) < 0)
+    {
+        return 1;
+    }
+
+    int64_t start = now_ns();
+    for (int64_t i = 0; i < samples; i++)
+    {
+        struct telemetry_sample s = sample_at(i);
+        telemetry_append(&t, &s);
+    }
+    double append_ns = (double)(now_ns() - start) / samples;
+    printf("%lld samples (%d days at %d s): %.1f ns per append, file %.2f MB\n", (long long)samples, BENCH_DAYS,
+           BENCH_PERIOD_MS / 1000, append_ns, t.size / 1048576.0);
+
+    int failures = 0;
+    printf("%12s %8s %11s %10s\n", "range", "points", "spacing", "query us");
+    for (int i = 0; i < ranges_count; i++)
+    {
+        failures += check_range(&t, samples, ranges[i], 1);
+    }
+
+    // History survives a restart
+    telemetry_close(&t);
+    if (telemetry_open(&t, BENCH_PATH) < 0)
+    {
+        return 1;
+    }
+    for (int i = 0; i < ranges_count; i++)
+    {
+        failures += check_range(&t, samples, ranges[i], 0);
+    }
+    printf("after reopen: %s\n", failures ? "MISMATCH" : "ok");
+    telemetry_close(&t);
+    unlink(BENCH_PATH);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,199 @@
+// Reads DS18B20 probes from a fake w1 sysfs tree. A helper thread plays
+// the kernel's part of therm_bulk_read: it takes 750 ms to "convert" and
+// then publishes every probe's temperature, odd probes in the older
+// w1_slave format. Checks the values and that N probes cost about one
+// conversion time instead of N, then that bad w1_slave and temperature
+// files (CRC failure, no t=, power-on reset) read as failures.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "hal.h"
+#include "w1.h"
+
+#define BENCH_PROBES 6
+
+static char root[W1_PATH_MAX];
+static atomic_int running = 1;
+
+static void write_file(const char *dir, const char *name, const char *content)
+{
+    char path[W1_PATH_MAX * 4];
+    if (snprintf(path, sizeof(path), "%s/%s", dir, name) >= (int)sizeof(path))
+    {
+        return;
+    }
+    FILE *file = fopen(path, "w");
+    fputs(content, file);
+    fclose(file);
+}
+
+static float probe_temp(int probe)
+{
+    return 40.0f + probe * 1.25f;
+}
+
+// A reading as the kernel shows it: even probes have the plain
+// temperature file, odd ones only w1_slave
+static void write_reading(const char *dir, int probe, int millidegrees)
+{
+    char value[128];
+    if (probe % 2 == 0)
+    {
+        snprintf(value, sizeof(value), "%d\n", millidegrees);
+        write_file(dir, "temperature", value);
+    }
+    else
+    {
+        snprintf(value, sizeof(value), "72 01 4b 46 7f ff 0e 10 57 : crc=57 YES\n72 01 4b 46 7f ff 0e 10 57 t=%d\n",
+                 millidegrees);
+        write_file(dir, "w1_slave", value);
+    }
+}
+
+// Fake kernel: trigger -> -1 for one conversion time -> temperatures + 1
+static void *fake_master(void *arg)
+{
+    (void)arg;
+    char master[W1_PATH_MAX * 2], status[32];
+    snprintf(master, sizeof(master), "%s/w1_bus_master1", root);
+
+    while (atomic_load(&running))
+    {
+        char path[W1_PATH_MAX * 3];
+        snprintf(path, sizeof(path), "%s/therm_bulk_read", master);
+        FILE *file = fopen(path, "r");
+        int triggered = file && fgets(status, sizeof(status), file) && strncmp(status, "trigger", 7) == 0;
+        if (file)
+        {
+            fclose(file);
+        }
+        if (!triggered)
+        {
+            usleep(1000);
+            continue;
+        }
+
+        write_file(master, "therm_bulk_read", "-1\n");
+        usleep(W1_CONVERSION_TIME * 1000000);
+        for (int i = 0; i < BENCH_PROBES; i++)
+        {
+            char probe[W1_PATH_MAX * 2];
+            snprintf(probe, sizeof(probe), "%s/28-00000000000%d", root, i);
+            write_reading(probe, i, (int)(probe_temp(i) * 1000));
+        }
+        write_file(master, "therm_bulk_read", "1\n");
+    }
+    return NULL;
+}
+
+// Probes read one by one, without a bus master. Only the first file is
+// valid; every other one must read -1.
+static int check_formats(void)
+{
+    static const char *const files[][2] = {
+        {"w1_slave", "50 05 4b 46 7f ff 0c 10 1c : crc=1c YES\n50 05 4b 46 7f ff 0c 10 1c t=85000\n"},
+        {"w1_slave", "50 05 4b 46 7f ff 0c 10 1c : crc=1c NO\n50 05 4b 46 7f ff 0c 10 1c t=21500\n"},
+        {"w1_slave", "72 01 4b 46 7f ff 0e 10 57 : crc=57 YES\n"},
+        {"temperature", "85000\n"},
+    };
+    char dir[W1_PATH_MAX * 2];
+    int count = sizeof(files) / sizeof(files[0]) + 1;
+    for (int i = 0; i < count; i++)
+    {
+        snprintf(dir, sizeof(dir), "%s/28-00000000000%d", root, i);
+        mkdir(dir, 0755);
+        if (i == 0)
+        {
+            write_reading(dir, 1, 23125);
+        }
+        else
+        {
+            write_file(dir, files[i - 1][0], files[i - 1][1]);
+        }
+    }
+
+    struct w1_bus bus;
+    float temps[W1_MAX_PROBES];
+    int errors = w1_open(&bus, root) != count || w1_read_all(&bus, temps) != 1;
+    for (int i = 0; i < bus.probe_count; i++)
+    {
+        int probe = bus.probes[i][strlen(root) + 15] - '0';
+        if (probe == 0 ? temps[i] < 23.124f || temps[i] > 23.126f : temps[i] != -1)
+        {
+            errors++;
+        }
+    }
+    printf("%d probe files, 1 valid, %d bad files rejected %s\n", count, count - 1, errors ? "FAIL" : "ok");
+    return errors;
+}
+
+int main(void)
+{
+    snprintf(root, sizeof(root), "/tmp/w1_bench.XXXXXX");
+    if (!mkdtemp(root))
+    {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    char dir[W1_PATH_MAX * 2];
+    snprintf(dir, sizeof(dir), "%s/w1_bus_master1", root);
+    mkdir(dir, 0755);
+    write_file(dir, "therm_bulk_read", "0\n");
+    for (int i = 0; i < BENCH_PROBES; i++)
+    {
+        snprintf(dir, sizeof(dir), "%s/28-00000000000%d", root, i);
+        mkdir(dir, 0755);
+        write_reading(dir, i, W1_POWER_ON_RESET);
+    }
+
+    hal_init();
+    pthread_t thread;
+    pthread_create(&thread, NULL, fake_master, NULL);
+
+    struct w1_bus bus;
+    int found = w1_open(&bus, root);
+
+    float temps[W1_MAX_PROBES];
+    double start = hal_time();
+    int valid = w1_read_all(&bus, temps);
+    double elapsed = hal_time() - start;
+
+    atomic_store(&running, 0);
+    pthread_join(thread, NULL);
+
+    int errors = found != BENCH_PROBES || valid != BENCH_PROBES || !bus.master[0];
+    for (int i = 0; i < bus.probe_count; i++)
+    {
+        // readdir order is arbitrary; match by the probe's index in its id
+        int probe = bus.probes[i][strlen(root) + 15] - '0';
+        if (temps[i] < probe_temp(probe) - 0.001f || temps[i] > probe_temp(probe) + 0.001f)
+        {
+            errors++;
+        }
+    }
+
+    printf("%d probes, %d valid, bulk %s: %.3f s (sequential would be ~%.2f s) %s\n",
+           found, valid, bus.master[0] ? "yes" : "no", elapsed,
+           BENCH_PROBES * W1_CONVERSION_TIME, errors ? "FAIL" : "ok");
+
+    char command[W1_PATH_MAX + 16];
+    snprintf(command, sizeof(command), "rm -rf %s", root);
+    system(command);
+
+    // Fresh tree for the format checks
+    snprintf(root, sizeof(root), "/tmp/w1_bench.XXXXXX");
+    if (!mkdtemp(root))
+    {
+        perror("mkdtemp");
+        return 1;
+    }
+    errors += check_formats();
+    snprintf(command, sizeof(command), "rm -rf %s", root);
+    system(command);
+    return errors != 0;
+}
@@ -0,0 +1,167 @@
+// Exercises the control-loop watchdog on the simulated backend with a
+// plain file standing in for /dev/watchdog. Healthy cycles must feed the
+// device and never trip; each injected stall must cut the heater, hold it
+// off until the next heartbeat and stop the feeding. Reports how late
+// after the deadline the heater was cut, and the cycle-time statistics
+// the daemon exports.
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "control.h"
+#include "hal.h"
+#include "hal_sim.h"
+#include "safety.h"
+#include "watchdog.h"
+
+#define BENCH_DEADLINE_MS 50
+#define BENCH_CYCLE_MS 10        // Heartbeat period while healthy
+#define BENCH_HEALTHY_MS 2500    // Long enough for a couple of device feeds
+#define BENCH_STALLS 100
+#define BENCH_LONG_STALL_MS 2500 // One stall spanning several feed intervals
+
+static struct drier drier;
+static int64_t detect_ns[BENCH_STALLS];
+
+static void sleep_ms(int ms)
+{
+    struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+static int compare_i64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Control cycles that each take `work_us`, for `duration_ms`
+static void run_healthy(int duration_ms, int work_us)
+{
+    int64_t end = watchdog_clock_ns() + duration_ms * 1000000LL;
+    while (watchdog_clock_ns() < end)
+    {
+        int64_t start = watchdog_clock_ns();
+        heater_set_duty(&drier, 1);
+        while (watchdog_clock_ns() - start < work_us * 1000LL)
+        {
+            // Busy, like a slow sensor read
+        }
+        watchdog_heartbeat(start);
+        sleep_ms(BENCH_CYCLE_MS);
+    }
+}
+
+// Stop heartbeating until the monitor cuts the heater. Returns how long
+// after the deadline that happened, or -1 if it never did.
+static int64_t stall(int max_ms)
+{
+    unsigned long missed = atomic_load(&watchdog_stats.missed);
+    int64_t due = atomic_load(&watchdog_stats.last_heartbeat_ns) + BENCH_DEADLINE_MS * 1000000LL;
+    for (int waited = 0; waited < max_ms; waited++)
+    {
+        sleep_ms(1);
+        if (atomic_load(&watchdog_stats.missed) != missed)
+        {
+            return atomic_load(&watchdog_stats.last_miss_ns) - due;
+        }
+    }
+    return -1;
+}
+
+int main(void)
+{
+    char device[] = "/tmp/watchdog_bench.XXXXXX";
+    int fd = mkstemp(device);
+    if (fd < 0)
+    {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+
+    hal_init();
+    control_init(&drier, OUTPUT_SWITCHED);
+    if (watchdog_start(BENCH_DEADLINE_MS * 1000000LL, device) < 0)
+    {
+        return 1;
+    }
+
+    int failures = 0;
+    run_healthy(BENCH_HEALTHY_MS, 500);
+    unsigned long feeds = atomic_load(&watchdog_stats.feeds);
+    if (atomic_load(&watchdog_stats.missed) != 0 || feeds < 2)
+    {
+        fprintf(stderr, "healthy loop: %lu missed, %lu feeds\n", atomic_load(&watchdog_stats.missed), feeds);
+        failures++;
+    }
+
+    for (int i = 0; i < BENCH_STALLS; i++)
+    {
+        heater_set_duty(&drier, 1);
+        detect_ns[i] = stall(10 * BENCH_DEADLINE_MS);
+        if (detect_ns[i] < 0)
+        {
+            fprintf(stderr, "stall %d: never detected\n", i);
+            return 1;
+        }
+
+        // Off, and the stuck loop's own writes cannot turn it back on
+        heater_set_duty(&drier, 1);
+        if (hal_sim_heater_level(TRANSISTOR) != 0.0)
+        {
+            fprintf(stderr, "stall %d: heater on after the trip\n", i);
+            failures++;
+        }
+
+        watchdog_heartbeat(watchdog_clock_ns());
+        heater_set_duty(&drier, 1);
+        if (hal_sim_heater_level(TRANSISTOR) != 1.0)
+        {
+            fprintf(stderr, "stall %d: heater still off after recovery\n", i);
+            failures++;
+        }
+    }
+
+    // A stall longer than the feed interval must starve the device
+    feeds = atomic_load(&watchdog_stats.feeds);
+    stall(BENCH_LONG_STALL_MS);
+    sleep_ms(BENCH_LONG_STALL_MS);
+    if (atomic_load(&watchdog_stats.feeds) != feeds)
+    {
+        fprintf(stderr, "device fed while the loop was stalled\n");
+        failures++;
+    }
+    watchdog_heartbeat(watchdog_clock_ns());
+    watchdog_stop();
+
+    // Fed bytes, then the magic close
+    FILE *file = fopen(device, "r");
+    struct stat st;
+    int last = EOF;
+    if (file && fseek(file, -1, SEEK_END) == 0)
+    {
+        last = fgetc(file);
+    }
+    if (!file || stat(device, &st) < 0 || st.st_size != (off_t)atomic_load(&watchdog_stats.feeds) + 1 ||
+        last != 'V')
+    {
+        fprintf(stderr, "device file does not hold the feeds and the magic close\n");
+        failures++;
+    }
+    if (file)
+    {
+        fclose(file);
+    }
+    unlink(device);
+    hal_terminate();
+
+    qsort(detect_ns, BENCH_STALLS, sizeof(detect_ns[0]), compare_i64);
+    printf("%lu cycles, worst cycle %.3f ms, %lu missed deadlines, %lu feeds, %d failures\n",
+           atomic_load(&watchdog_stats.cycles), atomic_load(&watchdog_stats.worst_cycle_ns) / 1e6,
+           atomic_load(&watchdog_stats.missed), atomic_load(&watchdog_stats.feeds), failures);
+    printf("deadline to heater off: p50 %.1f us, p99 %.1f us, max %.1f us\n", detect_ns[BENCH_STALLS / 2] / 1e3,
+           detect_ns[BENCH_STALLS * 99 / 100] / 1e3, detect_ns[BENCH_STALLS - 1] / 1e3);
+    return failures ? 1 : 0;
+}
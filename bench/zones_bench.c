@@ -0,0 +1,101 @@
+// Per-tick cost of the multi-zone controller as the rack grows. Each zone
+// gets its own simulated plant on the virtual clock. The sweep is what
+// the zone sampler thread does every period (every ADC read and filter);
+// the tick is what the control loop does (collect the published samples,
+// control, output), and should stay far below the sweep.
+#include <stdio.h>
+#include <time.h>
+#include "control.h"
+#include "hal.h"
+#include "hal_sim.h"
+#include "zones.h"
+
+#define BENCH_TICKS 2000
+#define BENCH_TICK_SECONDS 5.0
+#define BENCH_SETTLED_TICKS 200 // Last ticks averaged for the regulation check
+#define BENCH_BAND 2.0          // Largest mean error, in °C, of a regulated zone
+
+static const int zone_counts[] = {1, 10, 100, 250, 500};
+
+static double wall_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static struct drier drier;
+static struct zone_table zones;
+static double error_sum[MAX_ZONES];
+
+int main(void)
+{
+    int failures = 0;
+    printf("%6s %14s %14s %12s %10s\n", "zones", "sweep ns", "tick ns", "tick ns/zone", "in band");
+
+    for (size_t c = 0; c < sizeof(zone_counts) / sizeof(zone_counts[0]); c++)
+    {
+        int n = zone_counts[c];
+        hal_init();
+        hal_sim_use_virtual_clock(0.0);
+        control_init(&drier, OUTPUT_PWM);
+        zones_init(&zones, &drier);
+        for (int i = 0; i < n; i++)
+        {
+            // Alternate on/off and PID zones, setpoints spread over 40..70 °C
+            int zone = zones_add(&zones, i, i, 40.0 + (i % 7) * 5.0);
+            if (i % 2)
+            {
+                zones.kp[zone] = 0.08;
+                zones.ki[zone] = 0.0004;
+                zones.kd[zone] = 2.0;
+            }
+        }
+
+        double sweep_total = 0, tick_total = 0;
+        for (int i = 0; i < n; i++)
+        {
+            error_sum[i] = 0;
+        }
+        for (int t = 0; t < BENCH_TICKS; t++)
+        {
+            double start = wall_ns();
+            zones_sample(&zones);
+            double sampled = wall_ns();
+            zones_acquire(&zones);
+            zones_control(&zones, hal_time());
+            zones_service(&zones, hal_time());
+            double done = wall_ns();
+
+            sweep_total += sampled - start;
+            tick_total += done - sampled;
+            hal_sim_advance(BENCH_TICK_SECONDS);
+            if (t >= BENCH_TICKS - BENCH_SETTLED_TICKS)
+            {
+                for (int i = 0; i < n; i++)
+                {
+                    error_sum[i] += hal_sim_chamber_temp(i) - zones.desired_temp[i];
+                }
+            }
+        }
+
+        // Every zone must actually be regulated. On/off zones ripple by
+        // several degrees, so the check is on the error averaged over the
+        // settled ticks rather than on one instant.
+        int in_band = 0;
+        for (int i = 0; i < n; i++)
+        {
+            double error = error_sum[i] / BENCH_SETTLED_TICKS;
+            if (error > -BENCH_BAND && error < BENCH_BAND)
+            {
+                in_band++;
+            }
+        }
+        failures += in_band != n;
+
+        printf("%6d %14.0f %14.0f %12.1f %6d/%-3d\n", n, sweep_total / BENCH_TICKS,
+               tick_total / BENCH_TICKS, tick_total / BENCH_TICKS / n, in_band, n);
+        hal_terminate();
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,95 @@
+#include "adc.h"
+
+void adc_init(struct adc *adc, int type, const struct adc_bus *bus)
+{
+    adc->type = type;
+    adc->bus = *bus;
+}
+
+// MCP3008: start bit, single-ended + channel, then clock out 10 bits.
+// The chip only starts a conversion on a chip-select edge, so a scan is
+// one bus call carrying one 3-byte frame per conversion.
+static int mcp3008_scan(struct adc *adc, const int *channels, int count, float *volts)
+{
+    for (int i = 0; i < count; i++)
+    {
+        char *frame = &adc->tx[i * MCP3008_FRAME];
+        frame[0] = 0x01;
+        frame[1] = (char)(0x80 | ((channels[i] & 0x07) << 4));
+        frame[2] = 0x00;
+    }
+
+    if (adc->bus.spi_transfer(adc->bus.ctx, adc->tx, adc->rx, MCP3008_FRAME, count) < 0)
+    {
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        const unsigned char *frame = (const unsigned char *)&adc->rx[i * MCP3008_FRAME];
+        int value = ((frame[1] & 0x03) << 8) | frame[2];
+        volts[i] = value * (MCP3008_VREF / 1024.0);
+    }
+    return count;
+}
+
+// ADS1115: one multiplexed converter, so channels are converted in turn.
+// Each conversion is a config write, then after the nominal conversion
+// time the OS bit is polled until the result is ready, since a slow
+// internal oscillator would otherwise hand back the previous one.
+static int ads1115_scan(struct adc *adc, const int *channels, int count, float *volts)
+{
+    for (int i = 0; i < count; i++)
+    {
+        // Single-shot, AINx vs GND, +/-4.096 V, 860 SPS, comparator off
+        unsigned config = ADS1115_CONFIG_OS | ((4 + (channels[i] & 0x03)) << 12) | (1 << 9) | (1 << 8) | (7 << 5) | 0x03;
+        char buf[2] = {(char)(config >> 8), (char)(config & 0xff)};
+
+        if (adc->bus.i2c_write_reg(adc->bus.ctx, ADS1115_REG_CONFIG, buf, 2) < 0)
+        {
+            return -1;
+        }
+        adc->bus.delay(adc->bus.ctx, ADS1115_CONVERSION_TIME);
+        double waited = ADS1115_CONVERSION_TIME;
+        for (;;)
+        {
+            if (adc->bus.i2c_read_reg(adc->bus.ctx, ADS1115_REG_CONFIG, buf, 2) < 0)
+            {
+                return -1;
+            }
+            if (((unsigned char)buf[0] << 8) & ADS1115_CONFIG_OS)
+            {
+                break;
+            }
+            if (waited >= ADS1115_CONVERSION_TIMEOUT)
+            {
+                return -1;
+            }
+            adc->bus.delay(adc->bus.ctx, ADS1115_POLL_TIME);
+            waited += ADS1115_POLL_TIME;
+        }
+        if (adc->bus.i2c_read_reg(adc->bus.ctx, ADS1115_REG_CONVERSION, buf, 2) < 0)
+        {
+            return -1;
+        }
+
+        short value = (short)(((unsigned char)buf[0] << 8) | (unsigned char)buf[1]);
+        volts[i] = value * (ADS1115_FULL_SCALE / 32768.0);
+    }
+    return count;
+}
+
+// Convert `count` channels (repeats allowed, e.g. for oversampling) into
+// volts. Returns the number converted, or -1 on a bus error.
+int adc_scan(struct adc *adc, const int *channels, int count, float *volts)
+{
+    if (count > ADC_MAX_SCAN)
+    {
+        count = ADC_MAX_SCAN;
+    }
+    if (adc->type == ADC_ADS1115)
+    {
+        return ads1115_scan(adc, channels, count, volts);
+    }
+    return mcp3008_scan(adc, channels, count, volts);
+}
@@ -0,0 +1,49 @@
+#ifndef ADC_H
+#define ADC_H
+
+// Constants
+#define ADC_MCP3008 0            // 10-bit, 8 channels, SPI
+#define ADC_ADS1115 1            // 16-bit, 4 channels, I2C
+#define MCP3008_CHANNELS 8
+#define ADS1115_CHANNELS 4
+#define ADC_MAX_SCAN 32          // Conversions per scan
+#define MCP3008_FRAME 3          // Bytes per conversion frame
+#define MCP3008_VREF 3.3         // Reference voltage wired to VREF
+#define ADS1115_ADDRESS 0x48     // ADDR pin tied to GND
+#define ADS1115_FULL_SCALE 4.096 // PGA setting used for all channels
+#define ADS1115_CONVERSION_TIME (1.0 / 860) // Nominal conversion at 860 SPS; the
+                                             // oscillator may run 10% slower
+#define ADS1115_POLL_TIME 0.0001       // Between ready polls past the nominal time
+#define ADS1115_CONVERSION_TIMEOUT 0.005 // No ready bit by then: the chip is not converting
+#define ADS1115_CONFIG_OS 0x8000       // Written: start a conversion; read: set once done
+#define ADS1115_REG_CONVERSION 0x00
+#define ADS1115_REG_CONFIG 0x01
+
+// Struct definitions
+// Bus transport, so the drivers run against pigpio or a mock alike
+struct adc_bus
+{
+    void *ctx;
+    // `frames` transfers of `frame_len` bytes, chip select released between them
+    int (*spi_transfer)(void *ctx, char *tx, char *rx, unsigned frame_len, unsigned frames);
+    int (*i2c_write_reg)(void *ctx, unsigned reg, char *buf, unsigned count);
+    int (*i2c_read_reg)(void *ctx, unsigned reg, char *buf, unsigned count);
+    void (*delay)(void *ctx, double seconds);
+};
+
+struct adc
+{
+    int type;
+    struct adc_bus bus;
+    char tx[ADC_MAX_SCAN * MCP3008_FRAME]; // Preallocated transfer buffers
+    char rx[ADC_MAX_SCAN * MCP3008_FRAME];
+};
+
+// Function declarations
+void adc_init(struct adc *adc, int type, const struct adc_bus *bus);
+int adc_scan(struct adc *adc, const int *channels, int count, float *volts);
+int adc_pigpio_open_spi(struct adc_bus *bus, unsigned spi_channel, unsigned baud);
+int adc_pigpio_open_i2c(struct adc_bus *bus, unsigned i2c_bus, unsigned address);
+void adc_pigpio_close(struct adc_bus *bus);
+
+#endif /* ADC_H */
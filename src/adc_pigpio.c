@@ -0,0 +1,78 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <pigpio.h>
+#include "adc.h"
+
+static int pigpio_spi_transfer(void *ctx, char *tx, char *rx, unsigned frame_len, unsigned frames)
+{
+    unsigned handle = (unsigned)(intptr_t)ctx;
+
+    // pigpio drives the SPI block directly, so back-to-back frames cost no
+    // syscalls; each spiXfer toggles chip select as the MCP3008 requires
+    for (unsigned i = 0; i < frames; i++)
+    {
+        if (spiXfer(handle, tx + i * frame_len, rx + i * frame_len, frame_len) != (int)frame_len)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int pigpio_i2c_write_reg(void *ctx, unsigned reg, char *buf, unsigned count)
+{
+    return i2cWriteI2CBlockData((unsigned)(intptr_t)ctx, reg, buf, count) < 0 ? -1 : 0;
+}
+
+static int pigpio_i2c_read_reg(void *ctx, unsigned reg, char *buf, unsigned count)
+{
+    return i2cReadI2CBlockData((unsigned)(intptr_t)ctx, reg, buf, count) == (int)count ? 0 : -1;
+}
+
+static void pigpio_delay(void *ctx, double seconds)
+{
+    (void)ctx;
+    time_sleep(seconds);
+}
+
+int adc_pigpio_open_spi(struct adc_bus *bus, unsigned spi_channel, unsigned baud)
+{
+    int handle = spiOpen(spi_channel, baud, 0);
+    if (handle < 0)
+    {
+        return -1;
+    }
+    bus->ctx = (void *)(intptr_t)handle;
+    bus->spi_transfer = pigpio_spi_transfer;
+    bus->i2c_write_reg = NULL;
+    bus->i2c_read_reg = NULL;
+    bus->delay = pigpio_delay;
+    return 0;
+}
+
+int adc_pigpio_open_i2c(struct adc_bus *bus, unsigned i2c_bus, unsigned address)
+{
+    int handle = i2cOpen(i2c_bus, address, 0);
+    if (handle < 0)
+    {
+        return -1;
+    }
+    bus->ctx = (void *)(intptr_t)handle;
+    bus->spi_transfer = NULL;
+    bus->i2c_write_reg = pigpio_i2c_write_reg;
+    bus->i2c_read_reg = pigpio_i2c_read_reg;
+    bus->delay = pigpio_delay;
+    return 0;
+}
+
+void adc_pigpio_close(struct adc_bus *bus)
+{
+    if (bus->spi_transfer)
+    {
+        spiClose((unsigned)(intptr_t)bus->ctx);
+    }
+    else
+    {
+        i2cClose((unsigned)(intptr_t)bus->ctx);
+    }
+}
@@ -0,0 +1,511 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "api.h"
+#include "control.h"
+#include "log.h"
+#include "safety.h"
+#include "sampler.h"
+
+#define API_EVENTS 16
+#define API_BACKLOG 16
+#define API_INPUT_SIZE (sizeof(struct api_frame) + API_MAX_PAYLOAD)
+
+// Bytes queued in `data`, pending from `start`
+struct api_buffer
+{
+    unsigned char *data;
+    size_t size;
+    size_t start;
+    size_t length;
+};
+
+struct api_client
+{
+    int fd;                                // -1 while the slot is free
+    unsigned char input[API_INPUT_SIZE];   // At most one frame being assembled
+    size_t input_length;
+    unsigned char output_data[API_OUTPUT_SIZE];
+    struct api_buffer output;
+    uint32_t every;                        // Subscribed every N ticks, 0 if not
+    uint32_t countdown;                    // Ticks until the next sample
+    int writable;                          // Waiting for EPOLLOUT
+};
+
+// Global variables
+struct api_stats api_stats;
+
+// Preallocated so a connection never allocates on the control thread
+static struct api_client clients[API_MAX_CLIENTS];
+static int listen_fd = -1;
+static int api_epoll = -1;
+static char socket_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+static struct drier *api_drier;
+static const struct telemetry *telemetry_history;
+static uint32_t ticks = 0;
+
+static int64_t wall_clock_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void fill_status(struct api_status *status)
+{
+    const struct drier *d = api_drier;
+    float current_temp = sampler_latest_temperature(api_drier);
+
+    memset(status, 0, sizeof(*status));
+    status->time_ms = wall_clock_ms();
+    status->temperature = current_temp;
+    status->setpoint = d->desired_temp;
+    status->duty = d->heater_duty;
+    if (d->temp_change_duration > 0)
+    {
+        double left = d->temp_change_start + d->temp_change_duration - (double)control_clock_ns() / NS_PER_SECOND;
+        status->temporary_s = left > 0 ? (int32_t)ceil(left) : 0;
+    }
+    status->flags |= d->heater_state ? TELEMETRY_HEATING : 0;
+    status->flags |= current_temp < 0 ? TELEMETRY_SENSOR_FAULT : 0;
+    status->flags |= atomic_load(&safety_active) ? TELEMETRY_SAFETY : 0;
+    status->flags |= d->temp_change_duration > 0 ? TELEMETRY_TEMPORARY : 0;
+    status->tick = ticks;
+}
+
+// Append one frame to `out`. Returns -1 if it does not fit.
+static int put_frame(struct api_buffer *out, int type, int tag, const void *payload, size_t length)
+{
+    struct api_frame frame = {(uint16_t)length, (uint8_t)type, (uint8_t)tag};
+    size_t needed = sizeof(frame) + length;
+
+    if (length > API_MAX_PAYLOAD || out->length + needed > out->size)
+    {
+        return -1;
+    }
+    if (out->start + out->length + needed > out->size)
+    {
+        // Reclaim the space already sent
+        memmove(out->data, out->data + out->start, out->length);
+        out->start = 0;
+    }
+    unsigned char *p = out->data + out->start + out->length;
+    memcpy(p, &frame, sizeof(frame));
+    if (length > 0)
+    {
+        memcpy(p + sizeof(frame), payload, length);
+    }
+    out->length += needed;
+    return 0;
+}
+
+static int put_error(struct api_buffer *out, int tag, int code, const char *message)
+{
+    struct api_error error = {.code = code};
+    strncpy(error.message, message, sizeof(error.message) - 1);
+    return put_frame(out, API_ERROR, tag, &error, sizeof(error));
+}
+
+static int handle_request(const struct api_frame *frame, const unsigned char *payload, struct api_client *client,
+                          struct api_buffer *out, int nested);
+
+// Every request frame in a batch payload, answered into one reply frame
+static int handle_batch(const struct api_frame *frame, const unsigned char *payload, struct api_client *client,
+                        struct api_buffer *out)
+{
+    static unsigned char batch_data[API_MAX_PAYLOAD];
+    struct api_buffer batch = {batch_data, sizeof(batch_data), 0, 0};
+    size_t offset = 0;
+
+    while (offset + sizeof(struct api_frame) <= frame->length)
+    {
+        struct api_frame inner;
+        memcpy(&inner, payload + offset, sizeof(inner));
+        offset += sizeof(inner);
+        if (offset + inner.length > frame->length)
+        {
+            return put_error(out, frame->tag, API_ERR_MALFORMED, "Truncated request in batch");
+        }
+        if (handle_request(&inner, payload + offset, client, &batch, 1) < 0)
+        {
+            return put_error(out, frame->tag, API_ERR_TOO_LARGE, "Batch replies exceed one frame");
+        }
+        offset += inner.length;
+    }
+    if (offset != frame->length)
+    {
+        return put_error(out, frame->tag, API_ERR_MALFORMED, "Trailing bytes in batch");
+    }
+    return put_frame(out, API_BATCH_DATA, frame->tag, batch.data, batch.length);
+}
+
+// Answer one request into `out`. Returns -1 only if the reply does not fit.
+static int handle_request(const struct api_frame *frame, const unsigned char *payload, struct api_client *client,
+                          struct api_buffer *out, int nested)
+{
+    api_stats.requests++;
+    switch (frame->type)
+    {
+    case API_GET_STATUS:
+    {
+        struct api_status status;
+        fill_status(&status);
+        return put_frame(out, API_STATUS, frame->tag, &status, sizeof(status));
+    }
+    case API_SET_SETPOINT:
+    {
+        struct api_setpoint request;
+        if (frame->length != sizeof(request))
+        {
+            break;
+        }
+        memcpy(&request, payload, sizeof(request));
+        if (!(request.temperature >= 0 && request.temperature < MAX_TEMP) || request.seconds < 0)
+        {
+            return put_error(out, frame->tag, API_ERR_RANGE, "Setpoint or duration out of range");
+        }
+        set_temporary_temp(api_drier, request.temperature, request.seconds);
+        log_info("Temperature temporarily changed to %.1f°C for %d seconds (control socket)",
+                 api_drier->desired_temp, api_drier->temp_change_duration);
+        return put_frame(out, API_OK, frame->tag, NULL, 0);
+    }
+    case API_SUBSCRIBE:
+    {
+        struct api_subscribe request;
+        if (frame->length != sizeof(request))
+        {
+            break;
+        }
+        memcpy(&request, payload, sizeof(request));
+        client->every = request.every > 0 ? request.every : 1;
+        client->countdown = 1;
+        return put_frame(out, API_OK, frame->tag, NULL, 0);
+    }
+    case API_UNSUBSCRIBE:
+        client->every = 0;
+        return put_frame(out, API_OK, frame->tag, NULL, 0);
+    case API_GET_HISTORY:
+    {
+        static struct telemetry_bucket buckets[API_HISTORY_MAX_POINTS];
+        struct api_history request;
+        if (frame->length != sizeof(request))
+        {
+            break;
+        }
+        memcpy(&request, payload, sizeof(request));
+        if (!telemetry_history)
+        {
+            return put_error(out, frame->tag, API_ERR_UNAVAILABLE, "No history without --telemetry");
+        }
+        if (request.points == 0 || request.points > API_HISTORY_MAX_POINTS)
+        {
+            request.points = API_HISTORY_MAX_POINTS;
+        }
+        int count = telemetry_query(telemetry_history, request.from_ms, request.to_ms, request.points, buckets);
+        return put_frame(out, API_HISTORY_DATA, frame->tag, buckets, count * sizeof(buckets[0]));
+    }
+    case API_BATCH:
+        if (nested)
+        {
+            break;
+        }
+        return handle_batch(frame, payload, client, out);
+    }
+    return put_error(out, frame->tag, API_ERR_MALFORMED, "Unknown request or wrong payload size");
+}
+
+static void close_client(struct api_client *client)
+{
+    epoll_ctl(api_epoll, EPOLL_CTL_DEL, client->fd, NULL);
+    close(client->fd);
+    client->fd = -1;
+}
+
+// Send what the socket takes without blocking; wait for EPOLLOUT for the
+// rest. Returns -1 if the client went away.
+static int flush_client(struct api_client *client)
+{
+    struct api_buffer *out = &client->output;
+    while (out->length > 0)
+    {
+        ssize_t n = send(client->fd, out->data + out->start, out->length, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n < 0 && errno != EAGAIN)
+        {
+            return -1;
+        }
+        if (n < 0)
+        {
+            break;
+        }
+        out->start += n;
+        out->length -= n;
+    }
+    if (out->length == 0)
+    {
+        out->start = 0;
+    }
+
+    int writable = out->length > 0;
+    if (writable != client->writable)
+    {
+        struct epoll_event ev = {.events = EPOLLIN | (writable ? EPOLLOUT : 0), .data.ptr = client};
+        epoll_ctl(api_epoll, EPOLL_CTL_MOD, client->fd, &ev);
+        client->writable = writable;
+    }
+    return 0;
+}
+
+// One read per wakeup, so a chatty client cannot starve the others or
+// the loop; level-triggered epoll brings us back for the rest. A client
+// that sends an oversized frame or stops reading its replies is dropped.
+static void read_client(struct api_client *client)
+{
+    ssize_t n = recv(client->fd, client->input + client->input_length, sizeof(client->input) - client->input_length,
+                     MSG_DONTWAIT);
+    if (n < 0 && (errno == EAGAIN || errno == EINTR))
+    {
+        return;
+    }
+    if (n <= 0)
+    {
+        close_client(client);
+        return;
+    }
+    client->input_length += n;
+
+    size_t offset = 0;
+    while (client->input_length - offset >= sizeof(struct api_frame))
+    {
+        struct api_frame frame;
+        memcpy(&frame, client->input + offset, sizeof(frame));
+        if (frame.length > API_MAX_PAYLOAD)
+        {
+            api_stats.disconnected++;
+            close_client(client);
+            return;
+        }
+        if (client->input_length - offset < sizeof(frame) + frame.length)
+        {
+            break;
+        }
+        if (handle_request(&frame, client->input + offset + sizeof(frame), client, &client->output, 0) < 0)
+        {
+            api_stats.disconnected++;
+            close_client(client);
+            return;
+        }
+        offset += sizeof(frame) + frame.length;
+    }
+    client->input_length -= offset;
+    memmove(client->input, client->input + offset, client->input_length);
+
+    // Replies to everything read go out in one send
+    if (flush_client(client) < 0)
+    {
+        close_client(client);
+    }
+}
+
+static void accept_clients(void)
+{
+    for (;;)
+    {
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            return;
+        }
+
+        struct api_client *client = NULL;
+        for (int i = 0; i < API_MAX_CLIENTS && !client; i++)
+        {
+            client = clients[i].fd < 0 ? &clients[i] : NULL;
+        }
+        struct epoll_event ev = {.events = EPOLLIN, .data.ptr = client};
+        if (!client || epoll_ctl(api_epoll, EPOLL_CTL_ADD, fd, &ev) < 0)
+        {
+            api_stats.refused++;
+            close(fd);
+            continue;
+        }
+
+        client->fd = fd;
+        client->input_length = 0;
+        client->output = (struct api_buffer){client->output_data, sizeof(client->output_data), 0, 0};
+        client->every = 0;
+        client->writable = 0;
+        api_stats.accepted++;
+    }
+}
+
+// A socket file left by a daemon that is gone is removed; one that still
+// answers means another daemon owns it
+static int claim_path(const struct sockaddr_un *addr)
+{
+    struct stat st;
+    if (lstat(addr->sun_path, &st) < 0 || !S_ISSOCK(st.st_mode))
+    {
+        return 0;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int in_use = fd >= 0 && connect(fd, (const struct sockaddr *)addr, sizeof(*addr)) == 0;
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    if (in_use)
+    {
+        log_error("Control socket %s is in use by another process", addr->sun_path);
+        return -1;
+    }
+    unlink(addr->sun_path);
+    return 0;
+}
+
+// Listen on `path` for requests about `drier`. `history` answers
+// API_GET_HISTORY, NULL if there is none. Returns a descriptor for the
+// caller's event loop that is readable whenever api_service() has work,
+// or -1.
+int api_start(const char *path, struct drier *drier, const struct telemetry *history)
+{
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    if (strlen(path) >= sizeof(addr.sun_path))
+    {
+        log_error("Control socket path too long: %s", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+    if (claim_path(&addr) < 0)
+    {
+        return -1;
+    }
+
+    for (int i = 0; i < API_MAX_CLIENTS; i++)
+    {
+        clients[i].fd = -1;
+    }
+    api_drier = drier;
+    telemetry_history = history;
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    api_epoll = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event ev = {.events = EPOLLIN, .data.ptr = NULL};
+    if (listen_fd < 0 || api_epoll < 0 || bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        chmod(path, 0660) < 0 || listen(listen_fd, API_BACKLOG) < 0 ||
+        epoll_ctl(api_epoll, EPOLL_CTL_ADD, listen_fd, &ev) < 0)
+    {
+        log_error("Cannot listen on control socket %s: %s", path, strerror(errno));
+        api_stop();
+        return -1;
+    }
+    strcpy(socket_path, path);
+    return api_epoll;
+}
+
+// Safe to call when api_start never ran or failed part way: the client
+// slots only hold descriptors while the epoll instance exists
+void api_stop(void)
+{
+    if (listen_fd >= 0)
+    {
+        close(listen_fd);
+        listen_fd = -1;
+    }
+    if (api_epoll >= 0)
+    {
+        for (int i = 0; i < API_MAX_CLIENTS; i++)
+        {
+            if (clients[i].fd >= 0)
+            {
+                close_client(&clients[i]);
+            }
+        }
+        close(api_epoll);
+        api_epoll = -1;
+    }
+    if (socket_path[0])
+    {
+        unlink(socket_path);
+        socket_path[0] = '\0';
+    }
+}
+
+// Handle whatever is ready without waiting: new connections, requests
+// and sockets that can take more output
+void api_service(void)
+{
+    struct epoll_event events[API_EVENTS];
+    int count = epoll_wait(api_epoll, events, API_EVENTS, 0);
+    for (int i = 0; i < count; i++)
+    {
+        struct api_client *client = events[i].data.ptr;
+        if (!client)
+        {
+            accept_clients();
+            continue;
+        }
+        if (client->fd < 0)
+        {
+            continue; // Closed earlier in this batch
+        }
+        if (events[i].events & EPOLLIN)
+        {
+            read_client(client);
+        }
+        if (client->fd >= 0 && (events[i].events & EPOLLOUT) && flush_client(client) < 0)
+        {
+            close_client(client);
+        }
+        else if (client->fd >= 0 && (events[i].events & (EPOLLERR | EPOLLHUP)) && !(events[i].events & EPOLLIN))
+        {
+            close_client(client);
+        }
+    }
+}
+
+// A control tick happened: send subscribers a sample. The status is built
+// once; a subscriber whose buffer is full misses this one rather than
+// holding up the loop, and can tell from the tick numbers.
+void api_publish(void)
+{
+    struct api_status status;
+    int built = 0;
+
+    ticks++;
+    for (int i = 0; i < API_MAX_CLIENTS; i++)
+    {
+        struct api_client *client = &clients[i];
+        if (client->fd < 0 || client->every == 0 || --client->countdown > 0)
+        {
+            continue;
+        }
+        client->countdown = client->every;
+
+        if (!built)
+        {
+            fill_status(&status);
+            built = 1;
+        }
+        if (put_frame(&client->output, API_SAMPLE, 0, &status, sizeof(status)) < 0)
+        {
+            api_stats.dropped++;
+            continue;
+        }
+        api_stats.samples++;
+        if (!client->writable && flush_client(client) < 0)
+        {
+            close_client(client);
+        }
+    }
+}
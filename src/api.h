@@ -0,0 +1,106 @@
+#ifndef API_H
+#define API_H
+
+#include <stdint.h>
+#include "control.h"
+#include "telemetry.h"
+
+// Local control API on a Unix stream socket. Every message is a frame:
+// a 4-byte header giving the payload length, a type and a tag, then the
+// payload, all in host byte order. Replies carry the tag of the request
+// they answer, so requests can be pipelined; samples pushed to
+// subscribers have tag 0.
+
+// Constants
+#define API_SOCKET_PATH "/run/drier.sock"
+#define API_MAX_PAYLOAD 8192      // Largest frame payload either way
+#define API_MAX_CLIENTS 64        // Connections beyond this are refused
+#define API_OUTPUT_SIZE 32768     // Per-client replies and samples not yet sent
+#define API_HISTORY_MAX_POINTS (API_MAX_PAYLOAD / (int)sizeof(struct telemetry_bucket))
+
+// Requests
+#define API_GET_STATUS 1     // No payload; answered with API_STATUS
+#define API_SET_SETPOINT 2   // struct api_setpoint; answered with API_OK
+#define API_SUBSCRIBE 3      // struct api_subscribe; API_OK, then API_SAMPLE every N ticks
+#define API_UNSUBSCRIBE 4    // No payload; answered with API_OK
+#define API_GET_HISTORY 5    // struct api_history; answered with API_HISTORY_DATA
+#define API_BATCH 6          // Request frames back to back; answered with API_BATCH_DATA
+
+// Replies
+#define API_OK 0x80
+#define API_STATUS 0x81          // struct api_status
+#define API_SAMPLE 0x82          // struct api_status, once per subscribed tick
+#define API_HISTORY_DATA 0x83    // struct telemetry_bucket[], oldest first
+#define API_BATCH_DATA 0x84      // One reply frame per batched request, in order
+#define API_ERROR 0xFF           // struct api_error
+
+// Error codes
+#define API_ERR_MALFORMED 1      // Unknown type or wrong payload size
+#define API_ERR_RANGE 2          // Value out of range
+#define API_ERR_UNAVAILABLE 3    // E.g. history without --telemetry
+#define API_ERR_TOO_LARGE 4      // Reply would not fit in one frame
+
+// Struct definitions
+struct api_frame
+{
+    uint16_t length;  // Payload bytes after this header
+    uint8_t type;
+    uint8_t tag;      // Chosen by the client, echoed in the reply
+};
+
+struct api_status
+{
+    int64_t time_ms;        // Wall clock
+    float temperature;      // -1 without a valid reading
+    float setpoint;
+    float duty;             // Commanded heater duty, 0..1
+    int32_t temporary_s;    // Seconds until the setpoint reverts, 0 if held
+    uint32_t flags;         // TELEMETRY_* flags
+    uint32_t tick;          // Control ticks since start; gaps show dropped samples
+};
+
+struct api_setpoint
+{
+    float temperature;
+    int32_t seconds;        // 0 holds the setpoint indefinitely
+};
+
+struct api_subscribe
+{
+    uint32_t every;         // Ticks between samples, 0 or 1 for every tick
+};
+
+struct api_history
+{
+    int64_t from_ms;
+    int64_t to_ms;
+    uint32_t points;        // At most API_HISTORY_MAX_POINTS
+    uint32_t reserved;
+};
+
+struct api_error
+{
+    int32_t code;
+    char message[60];
+};
+
+struct api_stats
+{
+    unsigned long accepted;
+    unsigned long refused;       // API_MAX_CLIENTS reached
+    unsigned long requests;
+    unsigned long samples;       // Queued to subscribers
+    unsigned long dropped;       // Not queued: the subscriber was too slow
+    unsigned long disconnected;  // Closed for a malformed frame or a full buffer
+};
+
+// Global variables
+extern struct api_stats api_stats;
+
+// Function declarations
+int api_start(const char *path, struct drier *drier, const struct telemetry *history);
+void api_stop(void);
+void api_service(void);
+void api_publish(void);
+
+#endif /* API_H */
@@ -0,0 +1,331 @@
+#include <stddef.h>
+#include <string.h>
+#include "control.h"
+#include "hal.h"
+#include "log.h"
+#include "filter.h"
+#include "output.h"
+#include "pid.h"
+#include "safety.h"
+#include "w1.h"
+
+static void revert_setpoint(struct timer *timer)
+{
+    struct drier *d = timer->arg;
+    d->desired_temp = DEFAULT_TEMP;
+    d->temp_change_duration = 0;
+    log_info("Reverting to default temperature: %.1f°C", d->desired_temp);
+}
+
+// Defaults for everything in `d`: on/off control at DEFAULT_TEMP, the
+// analog sensor, and the heater off in `output_mode`
+void control_init(struct drier *d, int output_mode)
+{
+    memset(d, 0, sizeof(*d));
+    d->desired_temp = DEFAULT_TEMP;
+    d->control_mode = CONTROL_BANG_BANG;
+    d->pid_gains_path = PID_GAINS_FILE;
+    d->sensor_source = SENSOR_ANALOG;
+
+    // Setup pins
+    d->output_mode = output_mode;
+    output_init(&d->heater_output, TRANSISTOR, output_mode);
+    safety_protect(TRANSISTOR);
+    filter_init(&d->temperature_filter);
+
+    pid_reset(&d->pid);
+    d->last_control_time = -1;
+
+    timer_wheel_init(&d->timers, control_clock_ns());
+    timer_init(&d->setpoint_revert, revert_setpoint, d);
+}
+
+// Command the heater in percent of full power (as a 0..1 fraction)
+void heater_set_duty(struct drier *d, float duty)
+{
+    output_set_duty(&d->heater_output, duty, hal_time());
+    d->heater_duty = d->heater_output.duty;
+    d->heater_state = d->heater_output.level;
+}
+
+// Drive time-proportioning edges. Returns the next time it is needed
+// (hal_time() seconds), or -1 when the output mode needs no servicing.
+double heater_service(struct drier *d)
+{
+    double next = output_service(&d->heater_output, hal_time());
+    d->heater_state = d->heater_output.level;
+    return next;
+}
+
+// Sleep until `deadline` (hal_time() seconds), switching the output on
+// time on the way. Used where no event loop arms a timer for it.
+void heater_sleep_until(struct drier *d, double deadline)
+{
+    for (;;)
+    {
+        double next = heater_service(d);
+        double now = hal_time();
+        if (next < 0 || next >= deadline)
+        {
+            hal_sleep(deadline - now);
+            return;
+        }
+        hal_sleep(next - now);
+    }
+}
+
+// Fill the filter window from an analog sensor. Returns the number of
+// readings attempted, or -1 on a bus error.
+static int acquire_analog(struct drier *d, int channel, struct temp_filter *filter)
+{
+    float volts[SENSOR_BURST_SIZE];
+
+    // Burst of conversions in one ADC scan instead of a few slow retries
+    int count = hal_sensor_read(channel, volts, SENSOR_BURST_SIZE);
+    if (count < 0)
+    {
+        return -1;
+    }
+
+    int invalid = 0;
+    float last_invalid = 0;
+    for (int i = 0; i < count; i++)
+    {
+        // Validate voltage reading
+        if (volts[i] < MIN_VALID_VOLTAGE || volts[i] > MAX_VALID_VOLTAGE)
+        {
+            invalid++;
+            last_invalid = volts[i];
+            continue;
+        }
+
+        // Convert to temperature
+        filter_add(filter, (volts[i] - 0.5) * 100.0);
+    }
+
+    // A disconnected sensor fails every reading of every burst: count them
+    // all, but log at most one rate-limited line per burst
+    if (invalid > 0)
+    {
+        d->sensor_invalid_readings += invalid;
+        log_warn("%d of %d voltage readings invalid on channel %d, last %.3f V", invalid, count, channel,
+                 last_invalid);
+    }
+    return count;
+}
+
+// Fill the filter window with one reading per DS18B20 probe
+static int acquire_w1(struct drier *d, struct temp_filter *filter)
+{
+    float temps[W1_MAX_PROBES];
+
+    w1_read_all(&d->w1_probes, temps);
+    for (int i = 0; i < d->w1_probes.probe_count; i++)
+    {
+        if (temps[i] < 0)
+        {
+            d->sensor_invalid_readings++;
+            continue;
+        }
+        filter_add(filter, temps[i]);
+    }
+    return d->w1_probes.probe_count;
+}
+
+// Median, safety cutoff and smoothing shared by every sensor source
+static float finish_reading(struct drier *d, struct temp_filter *filter, int count, int heater_pin)
+{
+    if (count <= 0)
+    {
+        log_error("Sensor read failed");
+        return -1;
+    }
+
+    // Check if we got enough valid readings for a meaningful median
+    if (filter->count <= count / 2)
+    {
+        log_error("Only %d of %d sensor readings valid", filter->count, count);
+        return -1;
+    }
+
+    // The median ignores single glitches, so one bad reading cannot trip this
+    float temperature = filter_median(filter);
+
+    // Validate temperature bounds
+    if (temperature < 0.0 || temperature > MAX_TEMP)
+    {
+        log_warn("Temperature out of range: %.1f°C, shutting down for safety", temperature);
+        // Cut the pin right away; the controller then commands 0 %
+        hal_heater_write(heater_pin, 0);
+        if (d->output_mode == OUTPUT_PWM)
+        {
+            hal_heater_pwm(heater_pin, 0);
+        }
+        return -1;
+    }
+
+    // Implausibly fast changes keep the previous estimate for a few bursts
+    filter_update(filter, temperature, hal_time());
+    return filter->estimate;
+}
+
+// Filtered temperature of the analog sensor on `channel`, whose heater is
+// cut immediately if it reads out of range. Negative on failure. Rejected
+// readings are counted on `d`.
+float read_analog_temperature(struct drier *d, int channel, int heater_pin, struct temp_filter *filter)
+{
+    filter_begin(filter);
+    int count = acquire_analog(d, channel, filter);
+    return finish_reading(d, filter, count, heater_pin);
+}
+
+float read_temperature(struct drier *d)
+{
+    if (d->sensor_source == SENSOR_W1)
+    {
+        filter_begin(&d->temperature_filter);
+        int count = acquire_w1(d, &d->temperature_filter);
+        return finish_reading(d, &d->temperature_filter, count, TRANSISTOR);
+    }
+    return read_analog_temperature(d, HEAT_SENSOR_CHANNEL, TRANSISTOR, &d->temperature_filter);
+}
+
+// PID mode with stored gains if there are any, otherwise tune first
+void control_use_pid(struct drier *d)
+{
+    float kp, ki, kd;
+    if (d->pid_gains_path && pid_load_gains(d->pid_gains_path, &kp, &ki, &kd) == 0)
+    {
+        pid_init(&d->pid, kp, ki, kd);
+        d->control_mode = CONTROL_PID;
+        log_info("Loaded PID gains: Kp=%.4f Ki=%.5f Kd=%.3f", kp, ki, kd);
+    }
+    else
+    {
+        d->control_mode = CONTROL_AUTOTUNE;
+        d->tuner_running = 0;
+        log_info("No stored PID gains, autotuning at the next setpoint");
+    }
+}
+
+static void control_bang_bang(struct drier *d, float current_temp)
+{
+    if (current_temp < (d->desired_temp - TEMP_TOLERANCE))
+    {
+        // Turn heater ON if temperature is below desired range
+        if (d->desired_temp < MAX_TEMP)
+        {
+            heater_set_duty(d, 1);
+        }
+    }
+    else if (current_temp > (d->desired_temp + TEMP_TOLERANCE))
+    {
+        // Turn heater OFF if temperature is above desired range
+        heater_set_duty(d, 0);
+    }
+}
+
+static void control_autotune(struct drier *d, float current_temp, double now)
+{
+    // Needs a setpoint above ambient to oscillate around
+    if (d->desired_temp <= DEFAULT_TEMP || d->desired_temp >= MAX_TEMP)
+    {
+        d->tuner_running = 0;
+        heater_set_duty(d, 0);
+        return;
+    }
+    if (!d->tuner_running || d->tuner.setpoint != d->desired_temp)
+    {
+        autotune_start(&d->tuner, d->desired_temp, now);
+        d->tuner_running = 1;
+        log_info("Autotuning PID at %.1f°C", d->desired_temp);
+    }
+
+    heater_set_duty(d, autotune_step(&d->tuner, current_temp, now));
+
+    if (d->tuner.done)
+    {
+        float kp, ki, kd;
+        d->tuner_running = 0;
+        if (autotune_gains(&d->tuner, &kp, &ki, &kd) == 0)
+        {
+            pid_init(&d->pid, kp, ki, kd);
+            if (d->pid_gains_path)
+            {
+                pid_save_gains(d->pid_gains_path, kp, ki, kd);
+            }
+            d->control_mode = CONTROL_PID;
+            log_info("Autotune complete: Kp=%.4f Ki=%.5f Kd=%.3f", kp, ki, kd);
+        }
+        else
+        {
+            d->control_mode = CONTROL_BANG_BANG;
+            log_warn("Autotune failed, falling back to on/off control");
+        }
+    }
+}
+
+void control_heater(struct drier *d, float current_temp)
+{
+    double now = hal_time();
+    float dt = d->last_control_time < 0 ? 0 : now - d->last_control_time;
+    d->last_control_time = now;
+
+    // If we got an error reading temperature, turn off heater for safety
+    if (current_temp < 0)
+    {
+        heater_set_duty(d, 0);
+        return;
+    }
+
+    switch (d->control_mode)
+    {
+    case CONTROL_PID:
+        heater_set_duty(d, d->desired_temp < MAX_TEMP ? pid_update(&d->pid, d->desired_temp, current_temp, dt) : 0);
+        break;
+    case CONTROL_AUTOTUNE:
+        control_autotune(d, current_temp, now);
+        break;
+    default:
+        control_bang_bang(d, current_temp);
+        break;
+    }
+}
+
+// hal_time() in nanoseconds: CLOCK_MONOTONIC on the Pi, virtual in the simulator
+int64_t control_clock_ns(void)
+{
+    return (int64_t)(hal_time() * NS_PER_SECOND);
+}
+
+// hal_time() of the next armed deadline, or -1 if there is none
+double control_next_deadline(struct drier *d)
+{
+    int64_t deadline = timer_wheel_next_deadline(&d->timers);
+    return deadline < 0 ? -1 : (double)deadline / NS_PER_SECOND;
+}
+
+// Run every timer that is due, including the setpoint revert
+void control_run_timers(struct drier *d)
+{
+    timer_wheel_expire(&d->timers, control_clock_ns());
+}
+
+// Hold a setpoint for `duration` seconds, then revert to DEFAULT_TEMP.
+// A duration of zero holds it indefinitely.
+void set_temporary_temp(struct drier *d, float temp, int duration)
+{
+    int64_t now = control_clock_ns();
+
+    d->desired_temp = temp;
+    d->temp_change_duration = duration;
+    d->temp_change_start = (double)now / NS_PER_SECOND;
+    if (duration > 0)
+    {
+        timer_arm(&d->timers, &d->setpoint_revert, now, now + duration * NS_PER_SECOND);
+    }
+    else
+    {
+        timer_cancel(&d->timers, &d->setpoint_revert);
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include "filter.h"
+#include "output.h"
+#include "pid.h"
+#include "sample_ring.h"
+#include "timers.h"
+#include "w1.h"
+
+// Constants
+#define HEAT_SENSOR_CHANNEL 0 // ADC channel of the analog temperature sensor
+#define TRANSISTOR 17        // GPIO17
+#define DEFAULT_TEMP 0.0     // Default desired temperature in Celsius
+#define TEMP_TOLERANCE 2.0   // Temperature tolerance range (+/-)
+#define SAMPLE_INTERVAL 5000 // Sample interval in milliseconds
+#define MAX_TEMP 100.0
+#define SENSOR_BURST_SIZE 9 // Readings per sample, median-filtered
+#define MIN_VALID_VOLTAGE 0.2
+#define MAX_VALID_VOLTAGE 3.0
+#define PID_GAINS_FILE "/var/lib/drier/pid_gains.conf" // Default home of the tuned gains
+
+// Sensor sources
+#define SENSOR_ANALOG 0 // Analog sensor on HEAT_SENSOR_CHANNEL of the ADC
+#define SENSOR_W1 1     // DS18B20 probes on the 1-Wire bus, median of all
+
+// Control modes
+#define CONTROL_BANG_BANG 0 // On/off with +/- TEMP_TOLERANCE hysteresis
+#define CONTROL_PID 1
+#define CONTROL_AUTOTUNE 2 // Relay autotune, then switches to CONTROL_PID
+
+// Struct definitions
+// One drier: setpoint, controller, heater output, sensor path and its
+// deadlines. Every control function takes the drier it works on, so the
+// daemon, the TUI and the simulator each own theirs, and nothing here
+// keeps state of its own.
+struct drier
+{
+    // Setpoint
+    float desired_temp;
+    double temp_change_start;
+    int temp_change_duration;
+    struct timer setpoint_revert;
+
+    // Heater
+    int output_mode;                 // OUTPUT_* mode given to control_init()
+    struct output_stage heater_output;
+    int heater_state;                // Heater pin currently on
+    float heater_duty;               // Commanded duty, 0..1
+
+    // Controller
+    int control_mode;
+    const char *pid_gains_path;      // NULL disables persistence
+    struct pid pid;
+    struct autotune tuner;
+    int tuner_running;
+    double last_control_time;
+
+    // Sensor
+    int sensor_source;
+    struct w1_bus w1_probes;         // Probes used when sensor_source is SENSOR_W1
+    struct temp_filter temperature_filter;
+    _Atomic unsigned long sensor_invalid_readings; // Written on the sampler thread
+
+    // Acquisition thread and the samples it publishes (sampler.c)
+    struct sample_ring samples;
+    pthread_t sampler_thread;
+    atomic_int sampler_running;
+
+    struct timer_wheel timers;       // Deadlines on the hal_time() clock
+};
+
+// Function declarations
+void control_init(struct drier *d, int output_mode);
+void heater_set_duty(struct drier *d, float duty);
+double heater_service(struct drier *d);
+void heater_sleep_until(struct drier *d, double deadline);
+float read_analog_temperature(struct drier *d, int channel, int heater_pin, struct temp_filter *filter);
+float read_temperature(struct drier *d);
+void control_use_pid(struct drier *d);
+void control_heater(struct drier *d, float current_temp);
+int64_t control_clock_ns(void);
+double control_next_deadline(struct drier *d);
+void control_run_timers(struct drier *d);
+void set_temporary_temp(struct drier *d, float temp, int duration);
+
+#endif /* CONTROL_H */
@@ -0,0 +1,15 @@
+#include "countdown.h"
+
+int countdown_total_seconds(const struct time *t)
+{
+    return t->seconds + (t->minutes * 60) + (t->hours * 3600) + (t->days * 86400);
+}
+
+// Split a number of seconds into days/hours/minutes/seconds for display
+void countdown_set(struct time *t, int total_seconds)
+{
+    t->days = total_seconds / 86400;
+    t->hours = total_seconds % 86400 / 3600;
+    t->minutes = total_seconds % 3600 / 60;
+    t->seconds = total_seconds % 60;
+}
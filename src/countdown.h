@@ -0,0 +1,18 @@
+#ifndef COUNTDOWN_H
+#define COUNTDOWN_H
+
+// Struct definitions
+// Display form of a duration; timers themselves are deadlines (timers.h)
+struct time
+{
+    int seconds;
+    int minutes;
+    int hours;
+    int days;
+};
+
+// Function declarations
+int countdown_total_seconds(const struct time *t);
+void countdown_set(struct time *t, int total_seconds);
+
+#endif /* COUNTDOWN_H */
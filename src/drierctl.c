@@ -0,0 +1,268 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "api.h"
+
+// Command-line client for the daemon's control socket (--socket).
+// Usage: drierctl [--socket=PATH] COMMAND [, COMMAND ...]
+//   status                    current temperature, setpoint and heater
+//   set TEMP [SECONDS]        hold TEMP for SECONDS, or until changed
+//   watch [EVERY]             print a sample every EVERY ticks until killed
+//   history SECONDS [POINTS]  min/mean/max over the last SECONDS (--telemetry)
+// Several commands separated by "," go out as one batch, e.g.
+//   drierctl set 70 43200 , status
+
+#define MAX_COMMANDS 16
+
+static unsigned char payload[API_MAX_PAYLOAD];
+
+static int connect_socket(const char *path)
+{
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || strlen(path) >= sizeof(addr.sun_path))
+    {
+        perror("socket");
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int read_exactly(int fd, void *data, size_t length)
+{
+    size_t done = 0;
+    while (done < length)
+    {
+        ssize_t n = read(fd, (unsigned char *)data + done, length - done);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return -1;
+        }
+        done += n;
+    }
+    return 0;
+}
+
+// Next frame from the daemon, its payload into `payload`
+static int read_frame(int fd, struct api_frame *frame)
+{
+    if (read_exactly(fd, frame, sizeof(*frame)) < 0 || frame->length > API_MAX_PAYLOAD ||
+        read_exactly(fd, payload, frame->length) < 0)
+    {
+        fprintf(stderr, "Connection to the daemon lost\n");
+        return -1;
+    }
+    return 0;
+}
+
+// Append a request frame to `out`; returns its size, or -1 if the
+// arguments are not a command
+static int build_request(char **args, int count, unsigned char *out, int tag)
+{
+    struct api_frame frame = {0, 0, (uint8_t)tag};
+    union
+    {
+        struct api_setpoint setpoint;
+        struct api_subscribe subscribe;
+        struct api_history history;
+    } body;
+    memset(&body, 0, sizeof(body));
+
+    if (count == 1 && strcmp(args[0], "status") == 0)
+    {
+        frame.type = API_GET_STATUS;
+    }
+    else if ((count == 2 || count == 3) && strcmp(args[0], "set") == 0)
+    {
+        frame.type = API_SET_SETPOINT;
+        frame.length = sizeof(body.setpoint);
+        body.setpoint.temperature = atof(args[1]);
+        body.setpoint.seconds = count == 3 ? atoi(args[2]) : 0;
+    }
+    else if ((count == 1 || count == 2) && strcmp(args[0], "watch") == 0)
+    {
+        frame.type = API_SUBSCRIBE;
+        frame.length = sizeof(body.subscribe);
+        body.subscribe.every = count == 2 ? atoi(args[1]) : 1;
+    }
+    else if ((count == 2 || count == 3) && strcmp(args[0], "history") == 0)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        int64_t now = (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+        frame.type = API_GET_HISTORY;
+        frame.length = sizeof(body.history);
+        body.history.from_ms = now - atoll(args[1]) * 1000;
+        body.history.to_ms = now;
+        body.history.points = count == 3 ? atoi(args[2]) : 60;
+    }
+    else
+    {
+        return -1;
+    }
+
+    memcpy(out, &frame, sizeof(frame));
+    memcpy(out + sizeof(frame), &body, frame.length);
+    return sizeof(frame) + frame.length;
+}
+
+static void print_status(const struct api_status *s)
+{
+    printf("tick %u: %.1f°C, setpoint %.1f°C", s->tick, s->temperature, s->setpoint);
+    if (s->temporary_s > 0)
+    {
+        printf(" for %d s more", s->temporary_s);
+    }
+    printf(", heater %s %.0f%%%s%s\n", (s->flags & TELEMETRY_HEATING) ? "on" : "off", s->duty * 100,
+           (s->flags & TELEMETRY_SAFETY) ? ", SAFETY CUTOFF" : "",
+           (s->flags & TELEMETRY_SENSOR_FAULT) ? ", sensor fault" : "");
+}
+
+// Print one reply frame whose payload starts at `data`. Returns 1 if it
+// was an error.
+static int print_reply(const struct api_frame *frame, const unsigned char *data)
+{
+    switch (frame->type)
+    {
+    case API_OK:
+        printf("ok\n");
+        return 0;
+    case API_STATUS:
+    case API_SAMPLE:
+    {
+        struct api_status status;
+        memcpy(&status, data, sizeof(status));
+        print_status(&status);
+        return 0;
+    }
+    case API_HISTORY_DATA:
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        int64_t now = (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+        printf("       ago   min °C  mean °C   max °C  setpoint   duty\n");
+        for (size_t i = 0; i < frame->length / sizeof(struct telemetry_bucket); i++)
+        {
+            struct telemetry_bucket b;
+            memcpy(&b, data + i * sizeof(b), sizeof(b));
+            printf("%9llds %8.1f %8.1f %8.1f %9.1f %5.0f%%\n", (long long)((now - b.start_ms) / 1000),
+                   b.min_temperature, b.mean_temperature, b.max_temperature, b.mean_setpoint, b.mean_duty * 100);
+        }
+        return 0;
+    }
+    case API_BATCH_DATA:
+    {
+        int errors = 0;
+        size_t offset = 0;
+        while (offset + sizeof(struct api_frame) <= frame->length)
+        {
+            struct api_frame inner;
+            memcpy(&inner, data + offset, sizeof(inner));
+            errors += print_reply(&inner, data + offset + sizeof(inner));
+            offset += sizeof(inner) + inner.length;
+        }
+        return errors > 0;
+    }
+    case API_ERROR:
+    {
+        struct api_error error;
+        memcpy(&error, data, sizeof(error));
+        error.message[sizeof(error.message) - 1] = '\0';
+        fprintf(stderr, "error %d: %s\n", error.code, error.message);
+        return 1;
+    }
+    }
+    fprintf(stderr, "Unexpected reply type 0x%02x\n", frame->type);
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = API_SOCKET_PATH;
+    int first = 1;
+    if (argc > 1 && strncmp(argv[1], "--socket=", 9) == 0)
+    {
+        path = argv[1] + 9;
+        first = 2;
+    }
+
+    // Split the arguments into commands at ","
+    static unsigned char request[sizeof(struct api_frame) + API_MAX_PAYLOAD];
+    unsigned char *p = request + sizeof(struct api_frame);
+    int commands = 0, watching = 0;
+    for (int start = first; start < argc; commands++)
+    {
+        int end = start;
+        while (end < argc && strcmp(argv[end], ",") != 0)
+        {
+            end++;
+        }
+        int size = commands < MAX_COMMANDS ? build_request(argv + start, end - start, p, commands + 1) : -1;
+        if (size < 0)
+        {
+            fprintf(stderr, "Usage: %s [--socket=PATH] status | set TEMP [SECONDS] | watch [EVERY] | "
+                            "history SECONDS [POINTS] [, ...]\n", argv[0]);
+            return 2;
+        }
+        watching |= strcmp(argv[start], "watch") == 0;
+        p += size;
+        start = end + 1;
+    }
+    if (commands == 0)
+    {
+        fprintf(stderr, "Usage: %s [--socket=PATH] COMMAND [, COMMAND ...]\n", argv[0]);
+        return 2;
+    }
+
+    // One command goes as it is; several are wrapped in a batch
+    unsigned char *send_from = request + sizeof(struct api_frame);
+    if (commands > 1)
+    {
+        struct api_frame batch = {(uint16_t)(p - send_from), API_BATCH, 0};
+        memcpy(request, &batch, sizeof(batch));
+        send_from = request;
+    }
+
+    int fd = connect_socket(path);
+    if (fd < 0)
+    {
+        return 1;
+    }
+    if (write(fd, send_from, p - send_from) != p - send_from)
+    {
+        perror("write");
+        return 1;
+    }
+
+    struct api_frame frame;
+    if (read_frame(fd, &frame) < 0)
+    {
+        return 1;
+    }
+    int status = print_reply(&frame, payload);
+
+    // Samples keep coming until we are killed or the daemon stops
+    while (watching && status == 0 && read_frame(fd, &frame) == 0)
+    {
+        print_reply(&frame, payload);
+        fflush(stdout);
+    }
+    close(fd);
+    return status;
+}
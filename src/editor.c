@@ -0,0 +1,139 @@
+#include <string.h>
+#include "editor.h"
+
+#define KEY_ESCAPE 0x1b
+#define KEY_BACKSPACE 0x7f
+#define KEY_CTRL_H 0x08
+#define KEY_CTRL_U 0x15
+
+// Escape sequence parser states
+#define ESCAPE_NONE 0
+#define ESCAPE_START 1 // Got ESC
+#define ESCAPE_CSI 2   // Got ESC [
+#define ESCAPE_TILDE 3 // Got ESC [ 3, expecting ~
+
+void editor_start(struct line_editor *editor, const char *allowed)
+{
+    memset(editor->text, 0, sizeof(editor->text));
+    editor->length = 0;
+    editor->cursor = 0;
+    editor->escape = ESCAPE_NONE;
+    editor->allowed = allowed;
+}
+
+static void insert(struct line_editor *editor, char c)
+{
+    if (editor->length >= EDITOR_SIZE - 1)
+    {
+        return;
+    }
+    memmove(editor->text + editor->cursor + 1, editor->text + editor->cursor, editor->length - editor->cursor);
+    editor->text[editor->cursor++] = c;
+    editor->text[++editor->length] = '\0';
+}
+
+static void erase(struct line_editor *editor, int at)
+{
+    if (at < 0 || at >= editor->length)
+    {
+        return;
+    }
+    memmove(editor->text + at, editor->text + at + 1, editor->length - at);
+    editor->length--;
+    if (editor->cursor > at)
+    {
+        editor->cursor--;
+    }
+}
+
+// Arrow keys, Home/End and Delete arrive as ESC [ sequences
+static int escape_key(struct line_editor *editor, char c)
+{
+    switch (editor->escape)
+    {
+    case ESCAPE_START:
+        if (c != '[')
+        {
+            // A lone Esc followed by another key
+            editor->escape = ESCAPE_NONE;
+            return EDITOR_CANCEL;
+        }
+        editor->escape = ESCAPE_CSI;
+        return EDITOR_CONTINUE;
+    case ESCAPE_CSI:
+        editor->escape = ESCAPE_NONE;
+        if (c == 'D' && editor->cursor > 0)
+        {
+            editor->cursor--;
+        }
+        else if (c == 'C' && editor->cursor < editor->length)
+        {
+            editor->cursor++;
+        }
+        else if (c == 'H')
+        {
+            editor->cursor = 0;
+        }
+        else if (c == 'F')
+        {
+            editor->cursor = editor->length;
+        }
+        else if (c == '3')
+        {
+            editor->escape = ESCAPE_TILDE;
+        }
+        return EDITOR_CONTINUE;
+    default:
+        editor->escape = ESCAPE_NONE;
+        if (c == '~')
+        {
+            erase(editor, editor->cursor);
+        }
+        return EDITOR_CONTINUE;
+    }
+}
+
+// Feed one byte of input. Returns EDITOR_ACCEPT on Enter, EDITOR_CANCEL on
+// Esc, EDITOR_CONTINUE otherwise.
+int editor_key(struct line_editor *editor, char c)
+{
+    if (editor->escape != ESCAPE_NONE)
+    {
+        return escape_key(editor, c);
+    }
+
+    switch (c)
+    {
+    case '\n':
+    case '\r':
+        return EDITOR_ACCEPT;
+    case KEY_ESCAPE:
+        editor->escape = ESCAPE_START;
+        return EDITOR_CONTINUE;
+    case KEY_BACKSPACE:
+    case KEY_CTRL_H:
+        erase(editor, editor->cursor - 1);
+        return EDITOR_CONTINUE;
+    case KEY_CTRL_U:
+        editor_start(editor, editor->allowed);
+        return EDITOR_CONTINUE;
+    default:
+        if (c >= ' ' && c < KEY_BACKSPACE && (!editor->allowed || strchr(editor->allowed, c)))
+        {
+            insert(editor, c);
+        }
+        return EDITOR_CONTINUE;
+    }
+}
+
+// Call once the available input is drained: an Esc with nothing after it
+// was the Esc key itself rather than the start of a sequence
+int editor_idle(struct line_editor *editor)
+{
+    if (editor->escape == ESCAPE_START)
+    {
+        editor->escape = ESCAPE_NONE;
+        return EDITOR_CANCEL;
+    }
+    return EDITOR_CONTINUE;
+}
@@ -0,0 +1,28 @@
+#ifndef EDITOR_H
+#define EDITOR_H
+
+// Constants
+#define EDITOR_SIZE 32
+
+#define EDITOR_CONTINUE 0
+#define EDITOR_ACCEPT 1
+#define EDITOR_CANCEL 2
+
+// Struct definitions
+// Single-line editor fed one raw-mode keystroke at a time, so it never
+// blocks the loop that owns the terminal
+struct line_editor
+{
+    char text[EDITOR_SIZE];
+    int length;
+    int cursor;
+    int escape;          // Progress through an ESC [ x sequence
+    const char *allowed; // Accepted characters, NULL for any printable
+};
+
+// Function declarations
+void editor_start(struct line_editor *editor, const char *allowed);
+int editor_key(struct line_editor *editor, char c);
+int editor_idle(struct line_editor *editor);
+
+#endif /* EDITOR_H */
@@ -0,0 +1,96 @@
+#include <math.h>
+#include "filter.h"
+
+void filter_init(struct temp_filter *filter)
+{
+    filter->count = 0;
+    filter->estimate = 0;
+    filter->variance = 0;
+    filter->last_time = 0;
+    filter->initialized = 0;
+    filter->consecutive_rejects = 0;
+    filter->outliers = 0;
+}
+
+// Start collecting a new burst
+void filter_begin(struct temp_filter *filter)
+{
+    filter->count = 0;
+}
+
+void filter_add(struct temp_filter *filter, float value)
+{
+    if (filter->count < FILTER_WINDOW_MAX)
+    {
+        filter->window[filter->count++] = value;
+    }
+}
+
+// Median of the current burst (sorts the window in place)
+float filter_median(struct temp_filter *filter)
+{
+    float *w = filter->window;
+    int n = filter->count;
+
+    // Insertion sort: the window is tiny and already in a register-friendly array
+    for (int i = 1; i < n; i++)
+    {
+        float value = w[i];
+        int j = i - 1;
+        while (j >= 0 && w[j] > value)
+        {
+            w[j + 1] = w[j];
+            j--;
+        }
+        w[j + 1] = value;
+    }
+
+    if (n % 2)
+    {
+        return w[n / 2];
+    }
+    return (w[n / 2 - 1] + w[n / 2]) / 2;
+}
+
+// Fold a burst median into the estimate. Returns -1 if it was rejected as
+// an outlier, in which case the estimate is unchanged.
+int filter_update(struct temp_filter *filter, float median, double now)
+{
+    if (!filter->initialized)
+    {
+        filter->estimate = median;
+        filter->variance = 0;
+        filter->last_time = now;
+        filter->initialized = 1;
+        return 0;
+    }
+
+    double dt = now - filter->last_time;
+    float deviation = median - filter->estimate;
+    float limit = FILTER_MAX_RATE * dt + FILTER_RATE_MARGIN;
+
+    if ((deviation > limit || deviation < -limit) &&
+        filter->consecutive_rejects < FILTER_MAX_REJECTS)
+    {
+        filter->consecutive_rejects++;
+        filter->outliers++;
+        return -1;
+    }
+
+    // Either plausible, or the jump persisted and is real: resynchronise
+    if (filter->consecutive_rejects >= FILTER_MAX_REJECTS)
+    {
+        filter->estimate = median;
+        filter->variance = 0;
+    }
+    else
+    {
+        // Weight by elapsed time so the lag does not depend on the sample rate
+        float alpha = dt > 0 ? 1 - expf(-dt / FILTER_EMA_TAU) : 0;
+        filter->estimate += alpha * deviation;
+        filter->variance = (1 - alpha) * (filter->variance + alpha * deviation * deviation);
+    }
+    filter->consecutive_rejects = 0;
+    filter->last_time = now;
+    return 0;
+}
@@ -0,0 +1,33 @@
+#ifndef FILTER_H
+#define FILTER_H
+
+// Constants
+#define FILTER_WINDOW_MAX 32    // Largest supported burst
+#define FILTER_EMA_TAU 1.0      // Smoothing time constant in seconds
+#define FILTER_MAX_RATE 2.0     // Degrees per second a drier can plausibly change
+#define FILTER_RATE_MARGIN 1.0  // Allowed jump on top of the rate limit
+#define FILTER_MAX_REJECTS 3    // Consecutive outliers before trusting the new level
+
+// Struct definitions
+// Burst median -> rate-of-change gate -> exponential moving average.
+// Everything lives in the struct; updates never allocate.
+struct temp_filter
+{
+    float window[FILTER_WINDOW_MAX]; // Scratch for the current burst
+    int count;                       // Valid readings in the current burst
+    float estimate;                  // Filtered temperature
+    float variance;                  // Exponentially weighted variance around it
+    double last_time;
+    int initialized;
+    int consecutive_rejects;
+    unsigned long outliers;          // Bursts rejected by the rate gate
+};
+
+// Function declarations
+void filter_init(struct temp_filter *filter);
+void filter_begin(struct temp_filter *filter);
+void filter_add(struct temp_filter *filter, float value);
+float filter_median(struct temp_filter *filter);
+int filter_update(struct temp_filter *filter, float median, double now);
+
+#endif /* FILTER_H */
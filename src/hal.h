@@ -0,0 +1,39 @@
+#ifndef HAL_H
+#define HAL_H
+
+// Hardware abstraction for the controller. Exactly one backend is linked
+// in: hal_pigpio.c on the Pi, hal_sim.c anywhere else.
+
+#include <stdint.h>
+
+// Constants
+#define HAL_INPUT 0
+#define HAL_OUTPUT 1
+#define HAL_PWM_FREQUENCY 1000 // Heater PWM frequency in Hz
+#define HAL_SPI_CHANNEL 0      // CE0
+#define HAL_SPI_BAUD 1000000   // MCP3008 at 3.3 V tops out around 1.35 MHz
+#define HAL_I2C_BUS 1
+#ifndef HAL_ADC
+#define HAL_ADC ADC_MCP3008    // Build with -DHAL_ADC=ADC_ADS1115 for the I2C ADC
+#endif
+
+// Edge callback, run on the HAL's own thread. `tick_us` is when the edge
+// happened on the hal_micros() clock.
+typedef void (*hal_edge_callback)(int pin, int level, uint32_t tick_us);
+
+// Function declarations
+int hal_init(void);
+void hal_terminate(void);
+void hal_pin_mode(int pin, int mode);
+void hal_register_zone(int sensor_channel, int heater_pin);
+int hal_sensor_channels(void);
+int hal_sensor_read(int channel, float *volts, int count);
+void hal_heater_write(int pin, int level);
+void hal_heater_pwm(int pin, float duty);
+int hal_watch_input(int pin, hal_edge_callback callback);
+int hal_read_input(int pin);
+uint32_t hal_micros(void);
+double hal_time(void);
+void hal_sleep(double seconds);
+
+#endif /* HAL_H */
@@ -0,0 +1,126 @@
+#include <time.h>
+#include <pigpio.h>
+#include "adc.h"
+#include "hal.h"
+
+static struct adc sensor_adc;
+
+int hal_init(void)
+{
+    if (gpioInitialise() < 0)
+    {
+        return -1;
+    }
+
+    struct adc_bus bus;
+    int opened = HAL_ADC == ADC_ADS1115 ? adc_pigpio_open_i2c(&bus, HAL_I2C_BUS, ADS1115_ADDRESS)
+                                        : adc_pigpio_open_spi(&bus, HAL_SPI_CHANNEL, HAL_SPI_BAUD);
+    if (opened < 0)
+    {
+        gpioTerminate();
+        return -1;
+    }
+    adc_init(&sensor_adc, HAL_ADC, &bus);
+    return 0;
+}
+
+void hal_terminate(void)
+{
+    adc_pigpio_close(&sensor_adc.bus);
+    gpioTerminate();
+}
+
+void hal_pin_mode(int pin, int mode)
+{
+    gpioSetMode(pin, mode == HAL_OUTPUT ? PI_OUTPUT : PI_INPUT);
+}
+
+// Wiring is physical on the real board; nothing to set up
+void hal_register_zone(int sensor_channel, int heater_pin)
+{
+    (void)sensor_channel;
+    (void)heater_pin;
+}
+
+// Inputs on the fitted ADC; higher channel numbers alias lower ones
+int hal_sensor_channels(void)
+{
+    return HAL_ADC == ADC_ADS1115 ? ADS1115_CHANNELS : MCP3008_CHANNELS;
+}
+
+// `count` conversions of one channel in a single scan
+int hal_sensor_read(int channel, float *volts, int count)
+{
+    int channels[ADC_MAX_SCAN];
+    if (count > ADC_MAX_SCAN)
+    {
+        count = ADC_MAX_SCAN;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        channels[i] = channel;
+    }
+    return adc_scan(&sensor_adc, channels, count, volts);
+}
+
+void hal_heater_write(int pin, int level)
+{
+    gpioWrite(pin, level ? 1 : 0);
+}
+
+// GPIO12/13/18/19 have hardware PWM; anything else uses pigpio's
+// DMA-timed PWM, which is still far smoother than the control cycle
+void hal_heater_pwm(int pin, float duty)
+{
+    if (pin == 12 || pin == 13 || pin == 18 || pin == 19)
+    {
+        gpioHardwarePWM(pin, HAL_PWM_FREQUENCY, (unsigned)(duty * 1000000));
+    }
+    else
+    {
+        gpioSetPWMfrequency(pin, HAL_PWM_FREQUENCY);
+        gpioSetPWMrange(pin, 1000);
+        gpioPWM(pin, (unsigned)(duty * 1000));
+    }
+}
+
+// Pulled-up input switched to ground, with `callback` on every edge.
+// Alerts timestamp the edge from pigpio's DMA sampler, so latencies
+// measured against hal_micros() include delivery. -DHAL_EDGE_ISR uses the
+// kernel interrupt instead, which usually wakes sooner but timestamps on
+// wakeup.
+int hal_watch_input(int pin, hal_edge_callback callback)
+{
+    if (gpioSetMode(pin, PI_INPUT) < 0 || gpioSetPullUpDown(pin, PI_PUD_UP) < 0)
+    {
+        return -1;
+    }
+#ifdef HAL_EDGE_ISR
+    return gpioSetISRFunc(pin, EITHER_EDGE, 0, callback) < 0 ? -1 : 0;
+#else
+    return gpioSetAlertFunc(pin, callback) < 0 ? -1 : 0;
+#endif
+}
+
+int hal_read_input(int pin)
+{
+    return gpioRead(pin);
+}
+
+// Microseconds since boot, wrapping every ~72 minutes
+uint32_t hal_micros(void)
+{
+    return gpioTick();
+}
+
+double hal_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void hal_sleep(double seconds)
+{
+    time_sleep(seconds);
+}
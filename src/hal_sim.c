@@ -0,0 +1,345 @@
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include "hal.h"
+#include "hal_sim.h"
+
+// Simulated drier: the chamber heats at SIM_HEATING_RATE with the heater
+// fully on and loses heat to the room proportionally to the difference.
+// The element itself warms and cools with a first-order lag, so the
+// chamber keeps rising for a while after the heater switches off.
+#define SIM_AMBIENT_TEMP 20.0  // Room temperature
+#define SIM_HEATING_RATE 0.5   // Degrees per second at full power
+#define SIM_LOSS_RATE 0.005    // Fraction of (temp - ambient) lost per second
+#define SIM_HEATER_LAG 20.0    // Element time constant in seconds
+#define SIM_NOISE 0.1          // Peak-to-peak sensor noise in degrees
+#define SIM_STEP 0.1           // Integration step in seconds
+#define SIM_ADC_MAX 1024       // Quantise like the MCP3008 on the real board
+#define SIM_ADC_VREF 3.3
+#define SIM_MAX_PLANTS 512     // Independent driers; also the channel and pin id range
+#define SIM_MAX_INPUTS 64      // Watched input pins
+#define SIM_EDGE_QUEUE 64      // Edges waiting for the alert thread
+
+// One plant per registered zone. Unregistered channels and pins all map to
+// plant 0, which is the single drier the controller uses by default.
+static double chamber_temp[SIM_MAX_PLANTS];
+static double element_power[SIM_MAX_PLANTS]; // 0..1, lags the commanded output
+static double heater_level[SIM_MAX_PLANTS];  // Average power, 0..1
+static double last_update[SIM_MAX_PLANTS];
+static short channel_plant[SIM_MAX_PLANTS];
+static short pin_plant[SIM_MAX_PLANTS];
+static int plant_count = 0;
+
+// The model is shared by the control loop, the sampler thread and edge
+// callbacks on the alert thread
+static pthread_mutex_t sim_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Inputs idle high (pulled up). Edges injected with hal_sim_set_input()
+// are delivered by a separate thread, like pigpio's alert thread.
+struct sim_edge
+{
+    int pin;
+    int level;
+    uint32_t tick_us;
+};
+
+static int input_level[SIM_MAX_INPUTS];
+static hal_edge_callback input_callback[SIM_MAX_INPUTS];
+static struct sim_edge edge_queue[SIM_EDGE_QUEUE];
+static int edge_head = 0, edge_tail = 0;
+static pthread_mutex_t edge_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t edge_ready = PTHREAD_COND_INITIALIZER;
+static pthread_t alert_thread;
+static int alert_running = 0;
+
+// When enabled, hal_time() returns virtual_now and hal_sleep() advances it
+// instantly, so the controller runs as fast as the CPU allows.
+static int virtual_clock = 0;
+static double virtual_now = 0.0;
+
+static double monotonic_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int plant_of(const short *map, int id)
+{
+    return (id >= 0 && id < SIM_MAX_PLANTS) ? map[id] : 0;
+}
+
+// Advance one plant's thermal model up to the current time
+static void sim_update(int plant)
+{
+    double now = hal_time();
+    double elapsed = now - last_update[plant];
+    last_update[plant] = now;
+
+    while (elapsed > 0)
+    {
+        double dt = elapsed < SIM_STEP ? elapsed : SIM_STEP;
+        element_power[plant] += (heater_level[plant] - element_power[plant]) * dt / SIM_HEATER_LAG;
+        chamber_temp[plant] += (SIM_HEATING_RATE * element_power[plant] -
+                                SIM_LOSS_RATE * (chamber_temp[plant] - SIM_AMBIENT_TEMP)) *
+                               dt;
+        elapsed -= dt;
+    }
+}
+
+static void sim_reset(double now)
+{
+    for (int i = 0; i < SIM_MAX_PLANTS; i++)
+    {
+        chamber_temp[i] = SIM_AMBIENT_TEMP;
+        element_power[i] = 0.0;
+        heater_level[i] = 0;
+        last_update[i] = now;
+        channel_plant[i] = 0;
+        pin_plant[i] = 0;
+    }
+    plant_count = 0;
+    for (int i = 0; i < SIM_MAX_INPUTS; i++)
+    {
+        input_level[i] = 1;
+    }
+}
+
+int hal_init(void)
+{
+    pthread_mutex_lock(&sim_lock);
+    sim_reset(hal_time());
+    pthread_mutex_unlock(&sim_lock);
+    return 0;
+}
+
+// Each registered zone gets its own simulated drier
+void hal_register_zone(int sensor_channel, int heater_pin)
+{
+    pthread_mutex_lock(&sim_lock);
+    if (plant_count >= SIM_MAX_PLANTS)
+    {
+        pthread_mutex_unlock(&sim_lock);
+        return;
+    }
+    if (sensor_channel >= 0 && sensor_channel < SIM_MAX_PLANTS)
+    {
+        channel_plant[sensor_channel] = plant_count;
+    }
+    if (heater_pin >= 0 && heater_pin < SIM_MAX_PLANTS)
+    {
+        pin_plant[heater_pin] = plant_count;
+    }
+    plant_count++;
+    pthread_mutex_unlock(&sim_lock);
+}
+
+void hal_terminate(void)
+{
+    if (alert_running)
+    {
+        pthread_mutex_lock(&edge_lock);
+        alert_running = 0;
+        pthread_cond_signal(&edge_ready);
+        pthread_mutex_unlock(&edge_lock);
+        pthread_join(alert_thread, NULL);
+    }
+    for (int i = 0; i < SIM_MAX_INPUTS; i++)
+    {
+        input_callback[i] = NULL;
+    }
+}
+
+void hal_pin_mode(int pin, int mode)
+{
+    (void)pin;
+    (void)mode;
+}
+
+// Every plant has its own channel
+int hal_sensor_channels(void)
+{
+    return SIM_MAX_PLANTS;
+}
+
+int hal_sensor_read(int channel, float *volts, int count)
+{
+    pthread_mutex_lock(&sim_lock);
+    int plant = plant_of(channel_plant, channel);
+    sim_update(plant);
+
+    for (int i = 0; i < count; i++)
+    {
+        // Same transfer function read_temperature() inverts: 10 mV/°C, 0.5 V offset
+        float noise = ((float)rand() / RAND_MAX - 0.5) * SIM_NOISE;
+        double voltage = (chamber_temp[plant] + noise) / 100.0 + 0.5;
+        int raw = (int)(voltage * SIM_ADC_MAX / SIM_ADC_VREF + 0.5);
+        if (raw < 0)
+        {
+            raw = 0;
+        }
+        else if (raw > SIM_ADC_MAX - 1)
+        {
+            raw = SIM_ADC_MAX - 1;
+        }
+        volts[i] = raw * (SIM_ADC_VREF / SIM_ADC_MAX);
+    }
+    pthread_mutex_unlock(&sim_lock);
+    return count;
+}
+
+void hal_heater_write(int pin, int level)
+{
+    pthread_mutex_lock(&sim_lock);
+    int plant = plant_of(pin_plant, pin);
+    sim_update(plant);
+    heater_level[plant] = level ? 1 : 0;
+    pthread_mutex_unlock(&sim_lock);
+}
+
+// PWM is far faster than the thermal model, so only its average matters
+void hal_heater_pwm(int pin, float duty)
+{
+    pthread_mutex_lock(&sim_lock);
+    int plant = plant_of(pin_plant, pin);
+    sim_update(plant);
+    heater_level[plant] = duty;
+    pthread_mutex_unlock(&sim_lock);
+}
+
+static void *alert_loop(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&edge_lock);
+    while (alert_running)
+    {
+        if (edge_head == edge_tail)
+        {
+            pthread_cond_wait(&edge_ready, &edge_lock);
+            continue;
+        }
+        struct sim_edge edge = edge_queue[edge_tail];
+        edge_tail = (edge_tail + 1) % SIM_EDGE_QUEUE;
+        hal_edge_callback callback = input_callback[edge.pin];
+
+        pthread_mutex_unlock(&edge_lock);
+        if (callback)
+        {
+            callback(edge.pin, edge.level, edge.tick_us);
+        }
+        pthread_mutex_lock(&edge_lock);
+    }
+    pthread_mutex_unlock(&edge_lock);
+    return NULL;
+}
+
+int hal_watch_input(int pin, hal_edge_callback callback)
+{
+    if (pin < 0 || pin >= SIM_MAX_INPUTS)
+    {
+        return -1;
+    }
+
+    pthread_mutex_lock(&edge_lock);
+    input_callback[pin] = callback;
+    if (!alert_running)
+    {
+        alert_running = 1;
+        if (pthread_create(&alert_thread, NULL, alert_loop, NULL) != 0)
+        {
+            alert_running = 0;
+            pthread_mutex_unlock(&edge_lock);
+            return -1;
+        }
+    }
+    pthread_mutex_unlock(&edge_lock);
+    return 0;
+}
+
+int hal_read_input(int pin)
+{
+    return (pin >= 0 && pin < SIM_MAX_INPUTS) ? input_level[pin] : 1;
+}
+
+uint32_t hal_micros(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+
+double hal_time(void)
+{
+    return virtual_clock ? virtual_now : monotonic_seconds();
+}
+
+void hal_sleep(double seconds)
+{
+    if (virtual_clock)
+    {
+        hal_sim_advance(seconds);
+        return;
+    }
+    struct timespec ts = {(time_t)seconds, (long)((seconds - (time_t)seconds) * 1e9)};
+    nanosleep(&ts, NULL);
+}
+
+// Switch to the virtual clock, starting at `start` seconds
+void hal_sim_use_virtual_clock(double start)
+{
+    virtual_clock = 1;
+    virtual_now = start;
+    for (int i = 0; i < SIM_MAX_PLANTS; i++)
+    {
+        last_update[i] = start;
+    }
+}
+
+void hal_sim_advance(double seconds)
+{
+    if (seconds > 0)
+    {
+        virtual_now += seconds;
+    }
+}
+
+// True temperature of the drier a sensor channel measures
+double hal_sim_chamber_temp(int channel)
+{
+    pthread_mutex_lock(&sim_lock);
+    int plant = plant_of(channel_plant, channel);
+    sim_update(plant);
+    double temp = chamber_temp[plant];
+    pthread_mutex_unlock(&sim_lock);
+    return temp;
+}
+
+// Power last commanded on a heater pin, 0..1
+double hal_sim_heater_level(int pin)
+{
+    pthread_mutex_lock(&sim_lock);
+    double level = heater_level[plant_of(pin_plant, pin)];
+    pthread_mutex_unlock(&sim_lock);
+    return level;
+}
+
+// Drive a watched input, as a thermostat or switch would. The edge is
+// timestamped now and its callback runs on the alert thread.
+void hal_sim_set_input(int pin, int level)
+{
+    if (pin < 0 || pin >= SIM_MAX_INPUTS || input_level[pin] == level)
+    {
+        return;
+    }
+    input_level[pin] = level;
+
+    pthread_mutex_lock(&edge_lock);
+    int next = (edge_head + 1) % SIM_EDGE_QUEUE;
+    if (next != edge_tail && input_callback[pin])
+    {
+        edge_queue[edge_head] = (struct sim_edge){pin, level, hal_micros()};
+        edge_head = next;
+        pthread_cond_signal(&edge_ready);
+    }
+    pthread_mutex_unlock(&edge_lock);
+}
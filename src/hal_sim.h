@@ -0,0 +1,13 @@
+#ifndef HAL_SIM_H
+#define HAL_SIM_H
+
+// Extra controls only available with the simulated backend
+
+// Function declarations
+void hal_sim_use_virtual_clock(double start);
+void hal_sim_advance(double seconds);
+double hal_sim_chamber_temp(int channel);
+void hal_sim_set_input(int pin, int level);
+double hal_sim_heater_level(int pin);
+
+#endif /* HAL_SIM_H */
@@ -0,0 +1,97 @@
+#include "histogram.h"
+
+static void bump(_Atomic uint64_t *counter, uint64_t by)
+{
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + by, memory_order_relaxed);
+}
+
+// Bucket index: the value's top HISTOGRAM_SUB_BITS + 1 bits, offset by
+// how far they had to be shifted down
+static int bucket_of(uint64_t value)
+{
+    int msb = 63 - __builtin_clzll(value | 1);
+    int shift = msb > HISTOGRAM_SUB_BITS ? msb - HISTOGRAM_SUB_BITS : 0;
+    return (shift << HISTOGRAM_SUB_BITS) + (int)(value >> shift);
+}
+
+// Largest value that lands in `bucket`
+static uint64_t bucket_upper(int bucket)
+{
+    if (bucket < 2 * HISTOGRAM_SUB_BUCKETS)
+    {
+        return bucket;
+    }
+    int shift = (bucket >> HISTOGRAM_SUB_BITS) - 1;
+    uint64_t mantissa = bucket - ((uint64_t)shift << HISTOGRAM_SUB_BITS);
+    return ((mantissa + 1) << shift) - 1;
+}
+
+// A handful of loads and stores with no read-modify-write atomics, cheap
+// enough to leave on around every phase of the control loop
+void histogram_record(struct histogram *h, int64_t value)
+{
+    uint64_t v = value < 0 ? 0 : (uint64_t)value;
+    if (v >= 1ULL << HISTOGRAM_MAX_BITS)
+    {
+        v = (1ULL << HISTOGRAM_MAX_BITS) - 1;
+    }
+    bump(&h->counts[bucket_of(v)], 1);
+    bump(&h->total, 1);
+    bump(&h->sum, v);
+    if (v > atomic_load_explicit(&h->max, memory_order_relaxed))
+    {
+        atomic_store_explicit(&h->max, v, memory_order_relaxed);
+    }
+}
+
+// Value at or below which `fraction` of the recordings fall, rounded up
+// to its bucket's upper edge but never past the maximum seen. 0 when
+// nothing has been recorded.
+int64_t histogram_percentile(const struct histogram *h, double fraction)
+{
+    uint64_t total = atomic_load_explicit(&h->total, memory_order_relaxed);
+    uint64_t max = atomic_load_explicit(&h->max, memory_order_relaxed);
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    uint64_t rank = (uint64_t)(fraction * total + 0.5);
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        seen += atomic_load_explicit(&h->counts[i], memory_order_relaxed);
+        if (seen >= rank)
+        {
+            uint64_t upper = bucket_upper(i);
+            return (int64_t)(upper < max ? upper : max);
+        }
+    }
+    // A reader racing the writer can see the total ahead of the buckets
+    return (int64_t)max;
+}
+
+// For each of `count` ascending bounds, the recordings at or below it, in
+// one pass. Whole buckets only, so like the percentiles each count is
+// within a bucket's width of exact.
+void histogram_cumulative(const struct histogram *h, const int64_t *bounds, int count, uint64_t *out)
+{
+    uint64_t seen = 0;
+    int bound = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS && bound < count; i++)
+    {
+        while (bound < count && (int64_t)bucket_upper(i) > bounds[bound])
+        {
+            out[bound++] = seen;
+        }
+        seen += atomic_load_explicit(&h->counts[i], memory_order_relaxed);
+    }
+    while (bound < count)
+    {
+        out[bound++] = seen;
+    }
+}
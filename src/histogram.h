@@ -0,0 +1,34 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Log-linear histogram of nanosecond durations in fixed memory: values
+// below HISTOGRAM_SUB_BUCKETS are exact, and every power of two above
+// that is split into HISTOGRAM_SUB_BUCKETS linear buckets, so any
+// percentile is within about 6% of the true value.
+
+// Constants
+#define HISTOGRAM_SUB_BITS 4
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_MAX_BITS 40 // Values clamp at 2^40 ns, about 18 minutes
+#define HISTOGRAM_BUCKETS ((HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+// Struct definitions
+// One writing thread per histogram; any thread may read it. Relaxed
+// atomics keep that race-free at the cost of a plain load and store.
+struct histogram
+{
+    _Atomic uint64_t counts[HISTOGRAM_BUCKETS];
+    _Atomic uint64_t total;
+    _Atomic uint64_t sum;
+    _Atomic uint64_t max;
+};
+
+// Function declarations
+void histogram_record(struct histogram *h, int64_t value);
+int64_t histogram_percentile(const struct histogram *h, double fraction);
+void histogram_cumulative(const struct histogram *h, const int64_t *bounds, int count, uint64_t *out);
+
+#endif /* HISTOGRAM_H */
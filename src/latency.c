@@ -0,0 +1,35 @@
+#include "latency.h"
+#include "log.h"
+#include "sampler.h"
+
+// Global variables
+struct histogram latency_phases[LATENCY_PHASES];
+
+const char *const latency_phase_names[LATENCY_PHASES] = {"acquire", "control", "status", "input",
+                                                         "tick", "jitter", "api", "metrics"};
+
+// Record the time since `since_ns` (monotonic_ns()) under `phase` and
+// return now, so consecutive phases chain off one clock read each
+int64_t latency_mark(int phase, int64_t since_ns)
+{
+    int64_t now = monotonic_ns();
+    histogram_record(&latency_phases[phase], now - since_ns);
+    return now;
+}
+
+void latency_report(void)
+{
+    log_info("%-8s %10s %12s %12s %12s %12s", "phase", "count", "mean us", "p50 us", "p99 us", "max us");
+    for (int i = 0; i < LATENCY_PHASES; i++)
+    {
+        const struct histogram *h = &latency_phases[i];
+        uint64_t total = atomic_load(&h->total);
+        if (total == 0)
+        {
+            continue;
+        }
+        log_info("%-8s %10llu %12.1f %12.1f %12.1f %12.1f", latency_phase_names[i], (unsigned long long)total,
+                atomic_load(&h->sum) / 1e3 / total, histogram_percentile(h, 0.50) / 1e3,
+                histogram_percentile(h, 0.99) / 1e3, atomic_load(&h->max) / 1e3);
+    }
+}
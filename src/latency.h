@@ -0,0 +1,26 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include "histogram.h"
+
+// Constants
+// Control-loop phases, each with its own histogram
+#define LATENCY_ACQUIRE 0 // read_temperature() on the sampler thread, or zones_acquire()
+#define LATENCY_CONTROL 1 // Timers plus control_heater() or zones_control()
+#define LATENCY_STATUS 2  // Status lines and the flush
+#define LATENCY_INPUT 3   // Reading and dispatching stdin
+#define LATENCY_TICK 4    // Timer expiry handled, start to finish
+#define LATENCY_JITTER 5  // Tick period's distance from SAMPLE_INTERVAL
+#define LATENCY_API 6     // Control socket requests and sample fan-out
+#define LATENCY_METRICS 7 // Serving metrics scrapes
+#define LATENCY_PHASES 8
+
+// Global variables
+extern struct histogram latency_phases[LATENCY_PHASES];
+extern const char *const latency_phase_names[LATENCY_PHASES];
+
+// Function declarations
+int64_t latency_mark(int phase, int64_t since_ns);
+void latency_report(void);
+
+#endif /* LATENCY_H */
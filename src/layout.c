@@ -0,0 +1,140 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "layout.h"
+
+#define LAYOUT_TEXT_MAX 256
+
+// Rows resolve against the box's top or bottom edge
+static int item_row(const struct layout *layout, int row)
+{
+    return layout->box_row + (row >= 0 ? row : layout->box_height + row);
+}
+
+static void add_label(struct layout *layout, int row, int col, const char *text)
+{
+    if (text && layout->label_count < LAYOUT_MAX_LABELS)
+    {
+        struct layout_label *label = &layout->labels[layout->label_count++];
+        label->row = row;
+        label->col = col;
+        label->text = text;
+    }
+}
+
+// A box filling the terminal with a one-row, two-column margin, and every
+// item resolved to absolute coordinates inside it
+void layout_compute(struct layout *layout, int rows, int cols,
+                    const struct layout_item *items, int item_count,
+                    const int *separators, int separator_count)
+{
+    memset(layout, 0, sizeof(*layout));
+    layout->rows = rows;
+    layout->cols = cols;
+    layout->box_row = 1;
+    layout->box_col = 3;
+    layout->box_width = cols - 4;
+    layout->box_height = rows - 2;
+
+    for (int i = 0; i < separator_count && i < LAYOUT_MAX_SEPARATORS; i++)
+    {
+        layout->separators[layout->separator_count++] = item_row(layout, separators[i]);
+    }
+
+    int inner_col = layout->box_col + 1;
+    for (int i = 0; i < item_count; i++)
+    {
+        const struct layout_item *item = &items[i];
+        int row = item_row(layout, item->row);
+        int col = (item->align == LAYOUT_CENTER ? inner_col + layout->box_width / 2 : inner_col) + item->offset;
+
+        add_label(layout, row, col, item->label);
+        col += item->label ? (int)strlen(item->label) : 0;
+
+        if (item->field >= 0 && item->field < LAYOUT_MAX_FIELDS)
+        {
+            struct layout_field *field = &layout->fields[item->field];
+            field->row = row;
+            field->col = col;
+            field->width = item->field_width > 0 ? item->field_width : layout->box_width + item->field_width;
+            if (field->width < 0)
+            {
+                field->width = 0;
+            }
+            col += field->width;
+        }
+        add_label(layout, row, col, item->suffix);
+    }
+}
+
+static void draw_rule(const struct layout *layout, struct screen *screen, int row,
+                      const char *left, const char *right)
+{
+    screen_text(screen, row, layout->box_col, left);
+    screen_fill(screen, row, layout->box_col + 1, layout->box_width - 2, "═");
+    screen_text(screen, row, layout->box_col + layout->box_width - 1, right);
+}
+
+// Everything that only changes with the terminal size: borders,
+// separators and labels. Fields are left blank.
+void layout_draw(const struct layout *layout, struct screen *screen)
+{
+    int bottom = layout->box_row + layout->box_height - 1;
+
+    screen_clear(screen);
+    draw_rule(layout, screen, layout->box_row, "╔", "╗");
+    for (int row = layout->box_row + 1; row < bottom; row++)
+    {
+        screen_text(screen, row, layout->box_col, "║");
+        screen_text(screen, row, layout->box_col + layout->box_width - 1, "║");
+    }
+    for (int i = 0; i < layout->separator_count; i++)
+    {
+        draw_rule(layout, screen, layout->separators[i], "╠", "╣");
+    }
+    draw_rule(layout, screen, bottom, "╚", "╝");
+
+    for (int i = 0; i < layout->label_count; i++)
+    {
+        const struct layout_label *label = &layout->labels[i];
+        screen_text(screen, label->row, label->col, label->text);
+    }
+}
+
+// Replace a field's contents; text past its width is clipped
+void layout_field_text(const struct layout *layout, struct screen *screen, int field, const char *text)
+{
+    const struct layout_field *f = &layout->fields[field];
+
+    screen_fill(screen, f->row, f->col, f->width, " ");
+    screen_text_clipped(screen, f->row, f->col, text, f->col + f->width - 1);
+}
+
+void layout_field_printf(const struct layout *layout, struct screen *screen, int field, const char *format, ...)
+{
+    char text[LAYOUT_TEXT_MAX];
+    va_list args;
+
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    layout_field_text(layout, screen, field, text);
+}
+
+// Fill the first `fraction` of a field with `glyph`, the rest with blanks
+void layout_field_bar(const struct layout *layout, struct screen *screen, int field, float fraction, const char *glyph)
+{
+    const struct layout_field *f = &layout->fields[field];
+    int filled = (int)(fraction * f->width);
+
+    if (filled < 0)
+    {
+        filled = 0;
+    }
+    else if (filled > f->width)
+    {
+        filled = f->width;
+    }
+    screen_fill(screen, f->row, f->col, filled, glyph);
+    screen_fill(screen, f->row, f->col + filled, f->width - filled, " ");
+}
@@ -0,0 +1,69 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include "screen.h"
+
+// Constants
+#define LAYOUT_LEFT 0            // Offset from the box's inner left edge
+#define LAYOUT_CENTER 1          // Offset from the box's centre column
+#define LAYOUT_NO_FIELD -1
+#define LAYOUT_MAX_LABELS 32
+#define LAYOUT_MAX_FIELDS 16
+#define LAYOUT_MAX_SEPARATORS 8
+
+// Struct definitions
+// One line of a panel: an optional static label, an optional field that
+// is rewritten on updates, and an optional static suffix after it.
+// Labels are ASCII so their width is their length.
+struct layout_item
+{
+    int row;            // From the box's top, or from its bottom if negative
+    int align;
+    int offset;
+    const char *label;
+    int field;          // Index into layout.fields, or LAYOUT_NO_FIELD
+    int field_width;    // Columns; zero or negative means box width minus this
+    const char *suffix;
+};
+
+struct layout_label
+{
+    int row;
+    int col;
+    const char *text;
+};
+
+struct layout_field
+{
+    int row;
+    int col;
+    int width;
+};
+
+// Absolute coordinates for one terminal size, computed once per resize
+struct layout
+{
+    int rows;
+    int cols;
+    int box_row;
+    int box_col;
+    int box_width;
+    int box_height;
+    int separators[LAYOUT_MAX_SEPARATORS];
+    int separator_count;
+    struct layout_label labels[LAYOUT_MAX_LABELS];
+    int label_count;
+    struct layout_field fields[LAYOUT_MAX_FIELDS];
+};
+
+// Function declarations
+void layout_compute(struct layout *layout, int rows, int cols,
+                    const struct layout_item *items, int item_count,
+                    const int *separators, int separator_count);
+void layout_draw(const struct layout *layout, struct screen *screen);
+void layout_field_text(const struct layout *layout, struct screen *screen, int field, const char *text);
+void layout_field_printf(const struct layout *layout, struct screen *screen, int field, const char *format, ...)
+    __attribute__((format(printf, 4, 5)));
+void layout_field_bar(const struct layout *layout, struct screen *screen, int field, float fraction, const char *glyph);
+
+#endif /* LAYOUT_H */
@@ -0,0 +1,416 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "log.h"
+
+#define LOG_LINE_SIZE (LOG_MESSAGE_SIZE + 64) // Timestamp, prefix and newline
+
+// Struct definitions
+struct log_record
+{
+    int64_t time_ns; // CLOCK_REALTIME
+    int level;
+    int length;
+    char text[LOG_MESSAGE_SIZE];
+};
+
+// Bounded multi-producer queue: a slot is free for the producer whose
+// position matches its sequence, and full for the writer at sequence + 1
+struct log_slot
+{
+    _Atomic uint64_t sequence;
+    struct log_record record;
+};
+
+// Global variables
+struct log_stats log_stats;
+
+static struct log_slot queue[LOG_QUEUE_SIZE];
+static _Atomic uint64_t enqueue_position;
+static uint64_t dequeue_position; // Writer only
+
+static struct log_site *_Atomic sites = NULL; // Rate-limited sites seen so far
+static pthread_t writer_thread;
+static _Atomic int writer_running = 0;
+static unsigned long reported_drops = 0;
+
+// Without a file, info goes to stdout and warnings and errors to stderr
+static const char *log_path = NULL;
+static int file_fd = -1;
+
+// Pending output per destination: [0] stdout or the file, [1] stderr
+static char batch[2][LOG_BATCH_SIZE];
+static size_t batch_length[2];
+
+static const char *level_prefix[] = {"", "Warning: ", "Error: "};
+
+static int64_t clock_ns(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static uint64_t hash_text(const char *text, int length)
+{
+    uint64_t hash = 14695981039346656037ULL; // FNV-1a
+    for (int i = 0; i < length; i++)
+    {
+        hash = (hash ^ (unsigned char)text[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static void write_all(int fd, const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t n = write(fd, data, length);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return;
+        }
+        data += n;
+        length -= n;
+    }
+}
+
+// Files get a timestamp; the terminal and the journal have their own
+static size_t format_line(char *out, const struct log_record *record)
+{
+    size_t length = 0;
+    if (file_fd >= 0)
+    {
+        time_t seconds = record->time_ns / 1000000000LL;
+        struct tm tm;
+        localtime_r(&seconds, &tm);
+        length = strftime(out, LOG_LINE_SIZE, "%Y-%m-%d %H:%M:%S", &tm);
+        length += snprintf(out + length, LOG_LINE_SIZE - length, ".%03d ",
+                           (int)(record->time_ns / 1000000 % 1000));
+    }
+    length += snprintf(out + length, LOG_LINE_SIZE - length, "%s%.*s\n", level_prefix[record->level],
+                       record->length, record->text);
+    return length < LOG_LINE_SIZE ? length : LOG_LINE_SIZE - 1;
+}
+
+static int destination(int level)
+{
+    return (file_fd < 0 && level > LOG_INFO) ? 1 : 0;
+}
+
+static int destination_fd(int index)
+{
+    return index ? STDERR_FILENO : file_fd >= 0 ? file_fd : STDOUT_FILENO;
+}
+
+// Records queue only once the writer runs; before that, and in programs
+// that never start it, lines are written synchronously
+static void write_direct(const struct log_record *record)
+{
+    char line[LOG_LINE_SIZE];
+    size_t length = format_line(line, record);
+    write_all(destination_fd(destination(record->level)), line, length);
+}
+
+static int enqueue(const struct log_record *record)
+{
+    uint64_t position = atomic_load_explicit(&enqueue_position, memory_order_relaxed);
+    struct log_slot *slot;
+    for (;;)
+    {
+        slot = &queue[position & (LOG_QUEUE_SIZE - 1)];
+        int64_t lag = (int64_t)(atomic_load_explicit(&slot->sequence, memory_order_acquire) - position);
+        if (lag == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&enqueue_position, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (lag < 0)
+        {
+            return 0; // Full: the writer has not caught up with this lap
+        }
+        else
+        {
+            position = atomic_load_explicit(&enqueue_position, memory_order_relaxed);
+        }
+    }
+    slot->record = *record;
+    atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+    return 1;
+}
+
+static int dequeue(struct log_record *record)
+{
+    struct log_slot *slot = &queue[dequeue_position & (LOG_QUEUE_SIZE - 1)];
+    if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != dequeue_position + 1)
+    {
+        return 0;
+    }
+    *record = slot->record;
+    atomic_store_explicit(&slot->sequence, dequeue_position + LOG_QUEUE_SIZE, memory_order_release);
+    dequeue_position++;
+    return 1;
+}
+
+// Rate limit and deduplicate a warning or error. Returns 1 to emit it.
+// Nothing here waits: a sample the writer is reading is simply not updated.
+static int admit(struct log_site *site, const struct log_record *record)
+{
+    if (!atomic_exchange(&site->registered, 1))
+    {
+        atomic_store(&site->window_start_ns, clock_ns(CLOCK_MONOTONIC));
+        struct log_site *head = atomic_load(&sites);
+        do
+        {
+            site->next = head;
+        } while (!atomic_compare_exchange_weak(&sites, &head, site));
+    }
+
+    uint64_t hash = hash_text(record->text, record->length);
+    int duplicate = atomic_exchange(&site->last_hash, hash) == hash;
+    if (!duplicate && atomic_fetch_add(&site->emitted, 1) < LOG_RATE_BURST)
+    {
+        return 1;
+    }
+
+    atomic_fetch_add(&site->suppressed, 1);
+    atomic_fetch_add(&log_stats.suppressed, 1);
+    if (!atomic_exchange(&site->busy, 1))
+    {
+        memcpy(site->sample, record->text, record->length + 1);
+        atomic_store(&site->busy, 0);
+    }
+    return 0;
+}
+
+// Format and queue a message. Never blocks: formatting happens on the
+// caller's stack and a full queue drops the record (counted) rather than wait.
+void log_write(struct log_site *site, const char *format, ...)
+{
+    struct log_record record;
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(record.text, sizeof(record.text), format, args);
+    va_end(args);
+    if (length < 0)
+    {
+        return;
+    }
+    record.length = length < LOG_MESSAGE_SIZE ? length : LOG_MESSAGE_SIZE - 1;
+    record.level = site->level;
+    record.time_ns = clock_ns(CLOCK_REALTIME);
+
+    if (site->level > LOG_INFO && !admit(site, &record))
+    {
+        return;
+    }
+    atomic_fetch_add(&log_stats.records, 1);
+    if (!atomic_load(&writer_running))
+    {
+        write_direct(&record);
+    }
+    else if (!enqueue(&record))
+    {
+        atomic_fetch_add(&log_stats.dropped, 1);
+    }
+}
+
+static void flush_batches(void)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        if (batch_length[i] > 0)
+        {
+            write_all(destination_fd(i), batch[i], batch_length[i]);
+            atomic_fetch_add(&log_stats.writes, 1);
+            atomic_fetch_add(&log_stats.bytes, batch_length[i]);
+            batch_length[i] = 0;
+        }
+    }
+}
+
+static void append(const struct log_record *record)
+{
+    int index = destination(record->level);
+    if (batch_length[index] + LOG_LINE_SIZE > LOG_BATCH_SIZE)
+    {
+        flush_batches();
+    }
+    batch_length[index] += format_line(batch[index] + batch_length[index], record);
+}
+
+// FILE -> FILE.1 -> ... -> FILE.LOG_KEEP_FILES, oldest discarded
+static void rotate(void)
+{
+    struct stat st;
+    if (file_fd < 0 || fstat(file_fd, &st) < 0 || st.st_size < LOG_MAX_BYTES)
+    {
+        return;
+    }
+
+    char from[PATH_MAX], to[PATH_MAX];
+    for (int i = LOG_KEEP_FILES - 1; i >= 1; i--)
+    {
+        snprintf(from, sizeof(from), "%s.%d", log_path, i);
+        snprintf(to, sizeof(to), "%s.%d", log_path, i + 1);
+        rename(from, to);
+    }
+    snprintf(to, sizeof(to), "%s.1", log_path);
+    rename(log_path, to);
+
+    int fd = open(log_path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd >= 0)
+    {
+        close(file_fd);
+        file_fd = fd;
+        atomic_fetch_add(&log_stats.rotations, 1);
+    }
+}
+
+// Close every finished rate-limit window, with a summary line for sites
+// that had messages suppressed in it
+static void summarize_sites(void)
+{
+    int64_t now = clock_ns(CLOCK_MONOTONIC);
+    for (struct log_site *site = atomic_load(&sites); site; site = site->next)
+    {
+        if (now - atomic_load(&site->window_start_ns) < LOG_RATE_WINDOW_S * 1000000000LL)
+        {
+            continue;
+        }
+
+        unsigned suppressed = atomic_load(&site->suppressed);
+        if (suppressed > 0)
+        {
+            if (atomic_exchange(&site->busy, 1))
+            {
+                continue; // A producer is writing the sample; next sweep
+            }
+            struct log_record record = {.time_ns = clock_ns(CLOCK_REALTIME), .level = site->level};
+            int length = snprintf(record.text, sizeof(record.text), "%.*s (×%u more in last %d s)",
+                                  LOG_MESSAGE_SIZE - 40, site->sample, suppressed, LOG_RATE_WINDOW_S);
+            atomic_store(&site->busy, 0);
+            record.length = length < LOG_MESSAGE_SIZE ? length : LOG_MESSAGE_SIZE - 1;
+            atomic_fetch_sub(&site->suppressed, suppressed);
+            append(&record);
+        }
+        atomic_store(&site->emitted, 0);
+        atomic_store(&site->last_hash, 0);
+        atomic_store(&site->window_start_ns, now);
+    }
+}
+
+static void *writer_main(void *arg)
+{
+    (void)arg;
+    struct timespec period = {LOG_FLUSH_MS / 1000, (LOG_FLUSH_MS % 1000) * 1000000L};
+    for (;;)
+    {
+        int running = atomic_load(&writer_running);
+
+        struct log_record record;
+        while (dequeue(&record))
+        {
+            append(&record);
+        }
+
+        unsigned long dropped = atomic_load(&log_stats.dropped);
+        if (dropped != reported_drops)
+        {
+            struct log_record note = {.time_ns = clock_ns(CLOCK_REALTIME), .level = LOG_WARN};
+            note.length = snprintf(note.text, sizeof(note.text), "Log queue full, %lu message(s) dropped",
+                                   dropped - reported_drops);
+            reported_drops = dropped;
+            append(&note);
+        }
+
+        summarize_sites();
+        flush_batches();
+        rotate();
+        if (!running)
+        {
+            return NULL;
+        }
+        nanosleep(&period, NULL);
+    }
+}
+
+// Send everything to `path`, rotated by size, instead of stdout/stderr.
+// Call while the writer is stopped.
+int log_open(const char *path)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Cannot open log file %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    if (file_fd >= 0)
+    {
+        close(file_fd);
+    }
+    file_fd = fd;
+    log_path = path;
+    return 0;
+}
+
+// Start the background writer. It stays at normal priority even when
+// started from a real-time thread.
+int log_start(void)
+{
+    for (int i = 0; i < LOG_QUEUE_SIZE; i++)
+    {
+        atomic_store(&queue[i].sequence, i);
+    }
+    atomic_store(&enqueue_position, 0);
+    dequeue_position = 0;
+
+    pthread_attr_t attr;
+    struct sched_param param = {.sched_priority = 0};
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_OTHER);
+    pthread_attr_setschedparam(&attr, &param);
+
+    atomic_store(&writer_running, 1);
+    int err = pthread_create(&writer_thread, &attr, writer_main, NULL);
+    pthread_attr_destroy(&attr);
+    if (err)
+    {
+        atomic_store(&writer_running, 0);
+        fprintf(stderr, "Failed to start log writer: %s\n", strerror(err));
+        return -1;
+    }
+    return 0;
+}
+
+// Write out everything queued and go back to synchronous writes
+void log_stop(void)
+{
+    if (atomic_exchange(&writer_running, 0))
+    {
+        pthread_join(writer_thread, NULL);
+
+        // Anything queued by a producer that raced the writer's last drain
+        struct log_record record;
+        while (dequeue(&record))
+        {
+            write_direct(&record);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Constants
+#define LOG_INFO 0
+#define LOG_WARN 1
+#define LOG_ERROR 2
+
+#define LOG_MESSAGE_SIZE 160   // Formatted text per record, truncated beyond
+#define LOG_QUEUE_SIZE 1024    // Records in flight; a power of two
+#define LOG_FLUSH_MS 100       // Writer wakeup period
+#define LOG_BATCH_SIZE 65536   // Bytes per write() from the writer
+#define LOG_MAX_BYTES (1024 * 1024) // Log file size that triggers rotation
+#define LOG_KEEP_FILES 3       // Rotated files kept as FILE.1 .. FILE.3
+#ifndef LOG_RATE_WINDOW_S
+#define LOG_RATE_WINDOW_S 60   // Rate-limit window for warnings and errors
+#endif
+#define LOG_RATE_BURST 5       // Messages per site per window before suppression
+
+// Struct definitions
+// One per LOG_* call site, created by the macros below. Warnings and
+// errors are rate-limited and deduplicated per site; info is not.
+struct log_site
+{
+    int level;
+    _Atomic int registered;
+    struct log_site *next;            // Registry the writer sweeps for summaries
+    _Atomic int64_t window_start_ns;
+    _Atomic unsigned emitted;         // In the current window
+    _Atomic unsigned suppressed;      // Rate-limited or duplicate, since the last summary
+    _Atomic uint64_t last_hash;       // Last emitted message, for deduplication
+    _Atomic int busy;                 // Guards sample; never waited on
+    char sample[LOG_MESSAGE_SIZE];    // Latest suppressed message
+};
+
+struct log_stats
+{
+    _Atomic unsigned long records;
+    _Atomic unsigned long dropped;    // Queue was full
+    _Atomic unsigned long suppressed; // Rate-limited or duplicate
+    _Atomic unsigned long writes;     // write() calls by the writer
+    _Atomic unsigned long bytes;
+    _Atomic unsigned long rotations;
+};
+
+// Global variables
+extern struct log_stats log_stats;
+
+// Each expansion owns a static site, so rate limits are per call site
+#define LOG_AT(lvl, ...)                                      \
+    do                                                        \
+    {                                                         \
+        static struct log_site log_site_ = {.level = (lvl)};  \
+        log_write(&log_site_, __VA_ARGS__);                   \
+    } while (0)
+#define log_info(...) LOG_AT(LOG_INFO, __VA_ARGS__)
+#define log_warn(...) LOG_AT(LOG_WARN, __VA_ARGS__)
+#define log_error(...) LOG_AT(LOG_ERROR, __VA_ARGS__)
+
+// Function declarations
+int log_open(const char *path);
+int log_start(void);
+void log_stop(void);
+void log_write(struct log_site *site, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+#endif /* LOG_H */
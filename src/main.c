@@ -1,165 +1,728 @@
 #include <stdio.h>
-#include <pigpio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
 #include <time.h>
 #include <signal.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+#include "api.h"
+#include "control.h"
+#include "hal.h"
+#include "latency.h"
+#include "log.h"
+#include "metrics.h"
+#include "rt.h"
+#include "safety.h"
+#include "sampler.h"
+#include "telemetry.h"
+#include "watchdog.h"
+#include "zones.h"
 
-#define HEAT_SENSOR_PIN 4    // GPIO4 temperature sensor
-#define TRANSISTOR 17        // GPIO17
-#define DEFAULT_TEMP 0.0     // Default desired temperature in Celsius
-#define TEMP_TOLERANCE 2.0   // Temperature tolerance range (+/-)
-#define SAMPLE_INTERVAL 5000 // Sample interval in milliseconds
-#define MAX_TEMP 100.0
-#define TEMP_READ_RETRIES 3
-#define MIN_VALID_VOLTAGE 0.2
-#define MAX_VALID_VOLTAGE 3.0
-#define SENSOR_READ_INTERVAL_MS 100 // Time between retry attempts
+#define HISTORY_MAX_POINTS 120 // Rows printed by the "history" command
+#define MAX_EVENTS 8
+#define INPUT_BUFFER_SIZE 64
 
 // Global variables
-float desired_temp = DEFAULT_TEMP;
-time_t temp_change_start = 0;
-int temp_change_duration = 0;
 volatile sig_atomic_t shutdown = 0;
 
-void signal_handler(int sig)
+// The drier this daemon controls; with --zones it only carries the shared
+// output mode, timers and counters
+static struct drier drier;
+
+// Interlock trips already reported
+static unsigned long reported_trips = 0;
+
+// Pending stdin bytes until a full line has arrived
+static char input_buffer[INPUT_BUFFER_SIZE];
+static size_t input_length = 0;
+
+// Multi-zone mode (--zones=FILE); the single drier's sensor and setpoint are unused then
+static struct zone_table zone_table;
+static int zones_enabled = 0;
+
+static struct telemetry telemetry;
+static int telemetry_enabled = 0;
+
+// Report interlock trips since the last tick. The heater was already cut
+// on the alert thread; this is only the log line.
+void report_safety(void)
+{
+    unsigned long trips = atomic_load(&safety_stats.trips);
+    if (trips != reported_trips)
+    {
+        reported_trips = trips;
+        int active = atomic_load(&safety_active);
+        const char *cause = (active & SAFETY_OVER_TEMP) ? ((active & SAFETY_LID_OPEN) ? "over-temperature, lid open" : "over-temperature")
+                            : (active & SAFETY_LID_OPEN) ? "lid open" : "since cleared";
+        log_warn("Safety cutoff (%s): heater off %u us after the edge, worst %u us, %lu trip(s)", cause,
+                 atomic_load(&safety_stats.last_latency_us), atomic_load(&safety_stats.worst_latency_us), trips);
+    }
+}
+
+static int64_t wall_clock_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+void record_telemetry(float current_temp)
+{
+    struct telemetry_sample sample = {
+        .time_ms = wall_clock_ms(),
+        .temperature = current_temp,
+        .setpoint = drier.desired_temp,
+        .duty = drier.heater_duty,
+    };
+    sample.flags |= drier.heater_state ? TELEMETRY_HEATING : 0;
+    sample.flags |= current_temp < 0 ? TELEMETRY_SENSOR_FAULT : 0;
+    sample.flags |= atomic_load(&safety_active) ? TELEMETRY_SAFETY : 0;
+    sample.flags |= drier.temp_change_duration > 0 ? TELEMETRY_TEMPORARY : 0;
+    telemetry_append(&telemetry, &sample);
+}
+
+// "history SECONDS [POINTS]": min/mean/max over the last SECONDS
+void print_history(int seconds, int points)
 {
-    shutdown = 1;
+    static struct telemetry_bucket buckets[HISTORY_MAX_POINTS];
+    if (points <= 0 || points > HISTORY_MAX_POINTS)
+    {
+        points = HISTORY_MAX_POINTS;
+    }
+    int64_t now = wall_clock_ms();
+    int count = telemetry_query(&telemetry, now - (int64_t)seconds * 1000, now, points, buckets);
+    log_info("       ago   min °C  mean °C   max °C  setpoint   duty");
+    for (int i = 0; i < count; i++)
+    {
+        log_info("%9llds %8.1f %8.1f %8.1f %9.1f %5.0f%%", (long long)((now - buckets[i].start_ms) / 1000),
+                 buckets[i].min_temperature, buckets[i].mean_temperature, buckets[i].max_temperature,
+                 buckets[i].mean_setpoint, buckets[i].mean_duty * 100);
+    }
 }
 
-float read_temperature(void)
+void sample_tick(void)
 {
-    float total_valid_readings = 0;
-    int valid_readings_count = 0;
+    report_safety();
+
+    // Never blocks: acquisition runs on the sampler thread
+    int64_t t = monotonic_ns();
+    struct sample latest;
+    sampler_latest(&drier, &latest);
+    float current_temp = latest.temperature;
 
-    // Try multiple readings to ensure validity
-    for (int i = 0; i < TEMP_READ_RETRIES; i++)
+    control_run_timers(&drier);
+
+    // Control heater based on current temperature
+    control_heater(&drier, current_temp);
+    t = latency_mark(LATENCY_CONTROL, t);
+
+    // Print status
+    log_info("Current: %.1f°C (variance %.3f), Desired: %.1f°C",
+             current_temp, latest.variance, drier.desired_temp);
+    if (telemetry_enabled)
     {
-        // Read raw value from temperature sensor
-        int raw_value = gpioRead(HEAT_SENSOR_PIN);
+        record_telemetry(current_temp);
+    }
+    latency_mark(LATENCY_STATUS, t);
+}
 
-        // Convert to voltage
-        float voltage = raw_value * (3.3 / 1024.0);
+// One pass over every zone. Never blocks: the zone sampler thread does
+// the ADC reads and this only collects what it published.
+void zones_tick(void)
+{
+    report_safety();
+    int64_t t = monotonic_ns();
+    zones_acquire(&zone_table);
+    zones_control(&zone_table, hal_time());
+    t = latency_mark(LATENCY_CONTROL, t);
 
-        // Validate voltage reading
-        if (voltage < MIN_VALID_VOLTAGE || voltage > MAX_VALID_VOLTAGE)
+    for (int i = 0; i < zone_table.count; i++)
+    {
+        log_info("Zone %d: Current: %.1f°C, Desired: %.1f°C, Duty: %.0f%%",
+                 i, zone_table.current_temp[i], zone_table.desired_temp[i], zone_table.duty[i] * 100);
+    }
+    latency_mark(LATENCY_STATUS, t);
+}
+
+void handle_command(const char *line)
+{
+    float new_temp;
+    int duration;
+    int zone;
+    int seconds, points = HISTORY_MAX_POINTS;
+    if (strcmp(line, "stats") == 0)
+    {
+        latency_report();
+    }
+    else if (telemetry_enabled && sscanf(line, "history %d %d", &seconds, &points) >= 1)
+    {
+        print_history(seconds, points);
+    }
+    else if (zones_enabled)
+    {
+        // "zone temp seconds"
+        if (sscanf(line, "%d %f %d", &zone, &new_temp, &duration) == 3 &&
+            zone >= 0 && zone < zone_table.count)
         {
-            fprintf(stderr, "Warning: Invalid voltage reading: %.2fV\n", voltage);
-            time_sleep(SENSOR_READ_INTERVAL_MS / 1000.0);
-            continue;
+            zones_set_temporary(&zone_table, zone, new_temp, duration);
+            log_info("Zone %d temporarily changed to %.1f°C for %d seconds", zone, new_temp, duration);
         }
+    }
+    else if (sscanf(line, "%f %d", &new_temp, &duration) == 2)
+    {
+        set_temporary_temp(&drier, new_temp, duration);
+        log_info("Temperature temporarily changed to %.1f°C for %d seconds",
+                 drier.desired_temp, drier.temp_change_duration);
+    }
+}
 
-        // Convert to temperature
-        float temperature = (voltage - 0.5) * 100.0;
+// Drain whatever is readable on stdin and dispatch complete lines.
+// Returns 0 on end of input, 1 otherwise.
+int handle_input(int fd)
+{
+    for (;;)
+    {
+        ssize_t n = read(fd, input_buffer + input_length, sizeof(input_buffer) - 1 - input_length);
+        if (n == 0)
+        {
+            return 0;
+        }
+        if (n < 0)
+        {
+            return (errno == EAGAIN || errno == EINTR) ? 1 : 0;
+        }
+        input_length += n;
+
+        char *line = input_buffer;
+        char *newline;
+        while ((newline = memchr(line, '\n', input_buffer + input_length - line)) != NULL)
+        {
+            *newline = '\0';
+            handle_command(line);
+            line = newline + 1;
+        }
 
-        // Validate temperature bounds
-        if (temperature < 0.0 || temperature > MAX_TEMP)
+        // Keep the incomplete tail; drop it if it can never become a valid line
+        input_length -= line - input_buffer;
+        memmove(input_buffer, line, input_length);
+        if (input_length == sizeof(input_buffer) - 1)
         {
-            fprintf(stderr, "Warning: Temperature out of range: %.1f°C, shutting down for safety\n", temperature);
-            gpioWrite(TRANSISTOR, 0);
-            return -1;
+            input_length = 0;
         }
+    }
+}
+
+int setup_timer(void)
+{
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0)
+    {
+        return -1;
+    }
 
-        total_valid_readings += temperature;
-        valid_readings_count++;
+    // First tick fires immediately, then every SAMPLE_INTERVAL
+    struct itimerspec spec = {
+        .it_interval = {SAMPLE_INTERVAL / 1000, (SAMPLE_INTERVAL % 1000) * 1000000L},
+        .it_value = {0, 1},
+    };
+    if (timerfd_settime(fd, 0, &spec, NULL) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
 
-        time_sleep(SENSOR_READ_INTERVAL_MS / 1000.0);
+// Arm a one-shot timer for an absolute hal_time(), or disarm it if when < 0
+void arm_timer_at(int fd, double when)
+{
+    struct itimerspec spec = {{0, 0}, {0, 0}};
+    if (when >= 0)
+    {
+        spec.it_value.tv_sec = (time_t)when;
+        spec.it_value.tv_nsec = (long)((when - (time_t)when) * 1e9);
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0)
+        {
+            spec.it_value.tv_nsec = 1;
+        }
     }
+    timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, NULL);
+}
 
-    // Check if we got any valid readings
-    if (valid_readings_count == 0)
+int setup_signals(void)
+{
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+
+    // Signals are delivered through the signalfd instead of async handlers
+    if (sigprocmask(SIG_BLOCK, &mask, NULL) < 0)
     {
-        fprintf(stderr, "Error: Failed to get valid temperature reading after %d attempts\n",
-                TEMP_READ_RETRIES);
         return -1;
     }
+    return signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+}
 
-    // Return average of valid readings
-    return total_valid_readings / valid_readings_count;
+int epoll_add(int epfd, int fd)
+{
+    struct epoll_event ev = {.events = EPOLLIN, .data.fd = fd};
+    return epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
 }
 
-void control_heater(float current_temp)
+int main(int argc, char **argv)
 {
-    // If we got an error reading temperature, turn off heater for safety
-    if (current_temp < 0)
+    int signal_fd = setup_signals();
+    if (signal_fd < 0)
+    {
+        log_error("Failed to set up signalfd: %s", strerror(errno));
+        return 1;
+    }
+
+    if (hal_init() < 0)
+    {
+        log_error("Failed to initialize hardware");
+        return 1;
+    }
+
+    // --pid: PID control with stored gains; --autotune: re-identify them;
+    // --gains=FILE: where the gains are stored (default /var/lib/drier/pid_gains.conf);
+    // --output=switched|pwm|window: heater output stage;
+    // --w1[=ROOT]: DS18B20 probes instead of the analog sensor;
+    // --zones=FILE: control every zone listed in FILE from this process;
+    // --watchdog[=DEVICE]: also feed the kernel watchdog (default /dev/watchdog)
+    // --telemetry=FILE: keep history in FILE, a ring of samples and summaries;
+    // --socket[=PATH]: serve the control API on a Unix socket (default /run/drier.sock);
+    // --metrics[=[ADDRESS:]PORT]: serve Prometheus metrics (default 127.0.0.1:9464);
+    // --log=FILE: log to FILE, rotated by size, instead of stdout/stderr;
+    // --rt[=PRIORITY]: SCHED_FIFO control and sampling threads with locked
+    // memory; --cpu=N: pin them to CPU N (default: the first isolated CPU)
+    int use_pid = 0;
+    int output_mode = OUTPUT_SWITCHED;
+    const char *w1_root = NULL;
+    const char *zones_path = NULL;
+    const char *watchdog_device = NULL;
+    const char *telemetry_path = NULL;
+    const char *socket_path = NULL;
+    const char *metrics_address = NULL;
+    const char *gains_path = PID_GAINS_FILE;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--pid") == 0)
+        {
+            use_pid = 1;
+        }
+        else if (strcmp(argv[i], "--autotune") == 0)
+        {
+            use_pid = 2;
+        }
+        else if (strncmp(argv[i], "--gains=", 8) == 0)
+        {
+            gains_path = argv[i] + 8;
+        }
+        else if (strcmp(argv[i], "--w1") == 0)
+        {
+            w1_root = W1_SYSFS_ROOT;
+        }
+        else if (strncmp(argv[i], "--w1=", 5) == 0)
+        {
+            w1_root = argv[i] + 5;
+        }
+        else if (strcmp(argv[i], "--watchdog") == 0)
+        {
+            watchdog_device = WATCHDOG_DEVICE;
+        }
+        else if (strncmp(argv[i], "--watchdog=", 11) == 0)
+        {
+            watchdog_device = argv[i] + 11;
+        }
+        else if (strncmp(argv[i], "--telemetry=", 12) == 0)
+        {
+            telemetry_path = argv[i] + 12;
+        }
+        else if (strcmp(argv[i], "--socket") == 0)
+        {
+            socket_path = API_SOCKET_PATH;
+        }
+        else if (strncmp(argv[i], "--socket=", 9) == 0)
+        {
+            socket_path = argv[i] + 9;
+        }
+        else if (strcmp(argv[i], "--metrics") == 0)
+        {
+            metrics_address = METRICS_DEFAULT_ADDRESS;
+        }
+        else if (strncmp(argv[i], "--metrics=", 10) == 0)
+        {
+            metrics_address = argv[i] + 10;
+        }
+        else if (strncmp(argv[i], "--log=", 6) == 0)
+        {
+            if (log_open(argv[i] + 6) < 0)
+            {
+                hal_terminate();
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--rt") == 0)
+        {
+            rt_priority = RT_DEFAULT_PRIORITY;
+        }
+        else if (strncmp(argv[i], "--rt=", 5) == 0)
+        {
+            rt_priority = atoi(argv[i] + 5);
+        }
+        else if (strncmp(argv[i], "--cpu=", 6) == 0)
+        {
+            rt_cpu = atoi(argv[i] + 6);
+        }
+        else if (strncmp(argv[i], "--zones=", 8) == 0)
+        {
+            zones_path = argv[i] + 8;
+        }
+        else if (strncmp(argv[i], "--output=", 9) == 0)
+        {
+            output_mode = output_parse_mode(argv[i] + 9);
+            if (output_mode < 0)
+            {
+                log_error("Unknown output mode '%s'", argv[i] + 9);
+                hal_terminate();
+                return 1;
+            }
+        }
+    }
+
+    if (rt_priority > 0)
     {
-        gpioWrite(TRANSISTOR, 0);
-        return;
+        if (rt_cpu < 0)
+        {
+            rt_cpu = rt_isolated_cpu();
+        }
+        rt_lock_memory();
+        if (rt_cpu >= 0)
+        {
+            log_info("Real-time mode: SCHED_FIFO priority %d on CPU %d", rt_priority, rt_cpu);
+        }
+        else
+        {
+            log_info("Real-time mode: SCHED_FIFO priority %d, unpinned", rt_priority);
+        }
     }
 
-    if (current_temp < (desired_temp - TEMP_TOLERANCE))
+    control_init(&drier, output_mode);
+    drier.pid_gains_path = gains_path;
+    if (w1_root)
     {
-        // Turn heater ON if temperature is below desired range
-        if (desired_temp < MAX_TEMP)
+        if (w1_open(&drier.w1_probes, w1_root) <= 0)
         {
-            gpioWrite(TRANSISTOR, 1);
+            log_error("No DS18B20 probes found under %s", w1_root);
+            hal_terminate();
+            return 1;
         }
+        drier.sensor_source = SENSOR_W1;
+        log_info("Using %d DS18B20 probe(s)%s", drier.w1_probes.probe_count,
+                 drier.w1_probes.master[0] ? " with bulk conversion" : "");
     }
-    else if (current_temp > (desired_temp + TEMP_TOLERANCE))
+    if (safety_init() < 0)
     {
-        // Turn heater OFF if temperature is above desired range
-        gpioWrite(TRANSISTOR, 0);
+        log_error("Failed to watch the thermostat and lid inputs");
+        hal_terminate();
+        return 1;
+    }
+    if (use_pid == 1)
+    {
+        control_use_pid(&drier);
+    }
+    else if (use_pid == 2)
+    {
+        drier.control_mode = CONTROL_AUTOTUNE;
     }
-}
 
-int main()
-{
-    signal(SIGINT, signal_handler);
-    if (gpioInitialise() < 0)
+    if (zones_path)
     {
-        fprintf(stderr, "Failed to initialize pigpio\n");
+        zones_init(&zone_table, &drier);
+        if (zones_load(&zone_table, zones_path) <= 0)
+        {
+            log_error("No zones loaded from %s", zones_path);
+            hal_terminate();
+            return 1;
+        }
+        if (zones_sampler_start(&zone_table) < 0)
+        {
+            hal_terminate();
+            return 1;
+        }
+        zones_enabled = 1;
+        log_info("Controlling %d zone(s)", zone_table.count);
+    }
+    else if (sampler_start(&drier) < 0)
+    {
+        hal_terminate();
         return 1;
     }
 
-    // Setup pins
-    gpioSetMode(HEAT_SENSOR_PIN, PI_INPUT);
-    gpioSetMode(TRANSISTOR, PI_OUTPUT);
+    if (telemetry_path && zones_enabled)
+    {
+        log_warn("Telemetry records the single drier; ignored with --zones");
+    }
+    else if (telemetry_path)
+    {
+        if (telemetry_open(&telemetry, telemetry_path) < 0)
+        {
+            sampler_stop(&drier);
+            hal_terminate();
+            return 1;
+        }
+        telemetry_enabled = 1;
+    }
 
-    printf("Temperature control system started.\n");
-    printf("currently set to temperature: %.1f°C\n", desired_temp);
+    int api_fd = -1;
+    if (socket_path && zones_enabled)
+    {
+        log_warn("The control socket drives the single drier; ignored with --zones");
+    }
+    else if (socket_path)
+    {
+        api_fd = api_start(socket_path, &drier, telemetry_enabled ? &telemetry : NULL);
+    }
+    int metrics_fd = -1;
+    if (metrics_address)
+    {
+        metrics_fd = metrics_start(metrics_address, &drier, zones_enabled ? &zone_table : NULL);
+    }
+    if ((socket_path && !zones_enabled && api_fd < 0) || (metrics_address && metrics_fd < 0))
+    {
+        api_stop();
+        metrics_stop();
+        if (telemetry_enabled)
+        {
+            telemetry_close(&telemetry);
+        }
+        if (zones_enabled)
+        {
+            zones_sampler_stop(&zone_table);
+            zones_all_off(&zone_table);
+        }
+        else
+        {
+            sampler_stop(&drier);
+        }
+        hal_terminate();
+        return 1;
+    }
 
-    while (!shutdown)
+    int timer_fd = setup_timer();
+    int output_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    int deadline_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (timer_fd < 0 || output_fd < 0 || deadline_fd < 0 || epoll_fd < 0 ||
+        epoll_add(epoll_fd, timer_fd) < 0 || epoll_add(epoll_fd, signal_fd) < 0 ||
+        epoll_add(epoll_fd, output_fd) < 0 || epoll_add(epoll_fd, deadline_fd) < 0 ||
+        (api_fd >= 0 && epoll_add(epoll_fd, api_fd) < 0) ||
+        (metrics_fd >= 0 && epoll_add(epoll_fd, metrics_fd) < 0))
+    {
+        log_error("Failed to set up event loop: %s", strerror(errno));
+        api_stop();
+        metrics_stop();
+        if (zones_enabled)
+        {
+            zones_sampler_stop(&zone_table);
+            zones_all_off(&zone_table);
+        }
+        else
+        {
+            sampler_stop(&drier);
+        }
+        heater_set_duty(&drier, 0);
+        hal_terminate();
+        return 1;
+    }
+
+    // stdin is optional: a pipe or /dev/null may not be pollable
+    fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL, 0) | O_NONBLOCK);
+    int stdin_open = epoll_add(epoll_fd, STDIN_FILENO) == 0;
+
+    log_info("Temperature control system started.");
+    if (!zones_enabled)
+    {
+        log_info("currently set to temperature: %.1f°C", drier.desired_temp);
+    }
+
+    // From here on every control tick must heartbeat in time
+    int status = 0;
+    if (watchdog_start(WATCHDOG_DEADLINE_MS * 1000000LL, watchdog_device) < 0)
     {
-        float current_temp = read_temperature();
-        if ()
+        shutdown = 1;
+        status = 1;
+    }
+
+    // From here on nothing on the control path waits for log I/O
+    log_start();
+
+    // Last, so the helper threads above keep normal priority
+    rt_enter();
 
-            // Check if temporary temperature change has expired
-            if (temp_change_duration > 0)
+    // The deadline timer tracks the earliest timer on the wheel
+    double armed_deadline = -1;
+    int64_t last_tick = 0; // For the period jitter
+
+    while (!shutdown)
+    {
+        struct epoll_event events[MAX_EVENTS];
+        int count = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+        if (count < 0)
+        {
+            if (errno == EINTR)
             {
-                time_t current_time = time(NULL);
-                if (current_time - temp_change_start >= temp_change_duration)
-                {
-                    desired_temp = DEFAULT_TEMP;
-                    temp_change_duration = 0;
-                    printf("Reverting to default temperature: %.1f°C\n", desired_temp);
-                }
+                continue;
             }
+            log_error("epoll_wait: %s", strerror(errno));
+            break;
+        }
 
-        // Control heater based on current temperature
-        control_heater(current_temp);
+        for (int i = 0; i < count; i++)
+        {
+            int fd = events[i].data.fd;
+            if (fd == timer_fd)
+            {
+                // Missed ticks are collapsed into one sample
+                uint64_t expirations;
+                if (read(timer_fd, &expirations, sizeof(expirations)) == sizeof(expirations))
+                {
+                    int64_t tick_start = monotonic_ns();
+                    if (last_tick > 0)
+                    {
+                        int64_t nominal = (int64_t)expirations * SAMPLE_INTERVAL * 1000000LL;
+                        histogram_record(&latency_phases[LATENCY_JITTER], llabs(tick_start - last_tick - nominal));
+                    }
+                    last_tick = tick_start;
 
-        // Print status
-        printf("Current: %.1f°C, Desired: %.1f°C\n", current_temp, desired_temp);
+                    if (watchdog_tripped())
+                    {
+                        log_info("Watchdog: control loop recovered, heater control resumes");
+                    }
+                    if (zones_enabled)
+                    {
+                        zones_tick();
+                        arm_timer_at(output_fd, zones_service(&zone_table, hal_time()));
+                    }
+                    else
+                    {
+                        sample_tick();
+                        arm_timer_at(output_fd, heater_service(&drier));
+                    }
+                    watchdog_heartbeat(tick_start);
+                    int64_t tick_end = latency_mark(LATENCY_TICK, tick_start);
 
-        // Check for temperature change input
-        // This is a simplified example - implement your input method
-        char input[32];
-        if (fgets(input, sizeof(input), stdin) != NULL)
-        {
-            float new_temp;
-            int duration;
-            if (sscanf(input, "%f %d", &new_temp, &duration) == 2)
+                    // Samples go out after the heartbeat, outside the tick's deadline
+                    if (api_fd >= 0)
+                    {
+                        api_publish();
+                        latency_mark(LATENCY_API, tick_end);
+                    }
+                }
+            }
+            else if (fd == output_fd)
             {
-                desired_temp = new_temp;
-                temp_change_duration = duration;
-                temp_change_start = time(NULL);
-                printf("Temperature temporarily changed to %.1f°C for %d seconds\n",
-                       desired_temp, temp_change_duration);
+                // Time-proportioning window edge
+                uint64_t expirations;
+                if (read(output_fd, &expirations, sizeof(expirations)) == sizeof(expirations))
+                {
+                    arm_timer_at(output_fd, zones_enabled ? zones_service(&zone_table, hal_time())
+                                                              : heater_service(&drier));
+                }
+            }
+            else if (fd == deadline_fd)
+            {
+                // Setpoint reverts and other deadlines, exactly when due
+                uint64_t expirations;
+                if (read(deadline_fd, &expirations, sizeof(expirations)) == sizeof(expirations))
+                {
+                    control_run_timers(&drier);
+                }
+            }
+            else if (fd == signal_fd)
+            {
+                struct signalfd_siginfo info;
+                if (read(signal_fd, &info, sizeof(info)) == sizeof(info))
+                {
+                    shutdown = 1;
+                }
+            }
+            else if (fd == api_fd)
+            {
+                int64_t api_start_ns = monotonic_ns();
+                api_service();
+                latency_mark(LATENCY_API, api_start_ns);
+            }
+            else if (fd == metrics_fd)
+            {
+                int64_t metrics_start_ns = monotonic_ns();
+                metrics_service();
+                latency_mark(LATENCY_METRICS, metrics_start_ns);
+            }
+            else if (fd == STDIN_FILENO && stdin_open)
+            {
+                int64_t input_start = monotonic_ns();
+                int open = handle_input(STDIN_FILENO);
+                latency_mark(LATENCY_INPUT, input_start);
+                if (!open)
+                {
+                    // End of input: keep controlling, stop watching stdin
+                    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, STDIN_FILENO, NULL);
+                    stdin_open = 0;
+                }
             }
         }
 
-        // Wait before next reading
-        time_sleep(SAMPLE_INTERVAL / 1000.0);
+        double next_deadline = control_next_deadline(&drier);
+        if (next_deadline != armed_deadline)
+        {
+            arm_timer_at(deadline_fd, next_deadline);
+            armed_deadline = next_deadline;
+        }
+    }
+
+    watchdog_stop();
+    log_stop();
+    log_info("Control cycles: %lu, worst %.3f ms, missed deadlines: %lu", atomic_load(&watchdog_stats.cycles),
+             atomic_load(&watchdog_stats.worst_cycle_ns) / 1e6, atomic_load(&watchdog_stats.missed));
+    latency_report();
+
+    unsigned long trips = atomic_load(&safety_stats.trips);
+    if (trips > 0)
+    {
+        log_info("Safety cutoffs: %lu, edge to heater off mean %llu us, worst %u us", trips,
+                 (unsigned long long)(atomic_load(&safety_stats.total_latency_us) / trips),
+                 atomic_load(&safety_stats.worst_latency_us));
+    }
+
+    api_stop();
+    metrics_stop();
+    close(epoll_fd);
+    close(deadline_fd);
+    close(output_fd);
+    close(timer_fd);
+    close(signal_fd);
+    if (zones_enabled)
+    {
+        zones_sampler_stop(&zone_table);
+        zones_all_off(&zone_table);
+    }
+    else
+    {
+        sampler_stop(&drier);
+    }
+    if (telemetry_enabled)
+    {
+        telemetry_close(&telemetry);
     }
-    gpioWrite(TRANSISTOR, 0);
-    gpioTerminate();
-    return 0;
+    heater_set_duty(&drier, 0);
+    hal_terminate();
+    return status;
 }
@@ -0,0 +1,465 @@
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include "control.h"
+#include "latency.h"
+#include "log.h"
+#include "metrics.h"
+#include "safety.h"
+#include "sampler.h"
+#include "watchdog.h"
+
+#define METRICS_BACKLOG 8
+#define METRICS_STALL_NS 2000000000LL  // A connection this old may be dropped for a new one
+
+struct metrics_connection
+{
+    int fd;                                   // -1 while the slot is free
+    int64_t accepted_ns;                      // Stalled ones are evicted, oldest first
+    char request[METRICS_REQUEST_SIZE];
+    size_t request_length;
+    char *response;                           // Header right before the body
+    size_t start;                             // Unsent bytes of response
+    size_t length;
+};
+
+// Output position while formatting; `truncated` once anything was cut
+struct metrics_writer
+{
+    char *p;
+    char *end;
+    int truncated;
+};
+
+// Global variables
+struct metrics_stats metrics_stats;
+
+static struct metrics_connection connections[METRICS_MAX_CONNECTIONS];
+static int listen_fd = -1;
+static int metrics_epoll = -1;
+static struct drier *metrics_drier;
+static const struct zone_table *metrics_zones;
+static int64_t started_ns;
+static size_t response_size;             // Of every connection's response buffer
+
+// Upper bounds of the exported phase histograms, with their labels
+static const int64_t phase_bounds_ns[] = {10000,   25000,    50000,    100000,   250000,    500000,    1000000,
+                                          2500000, 10000000, 50000000, 250000000, 1000000000, 5000000000LL};
+static const char *const phase_bounds_le[] = {"0.00001", "0.000025", "0.00005", "0.0001", "0.00025",
+                                              "0.0005",  "0.001",    "0.0025",  "0.01",   "0.05",
+                                              "0.25",    "1",        "5"};
+#define PHASE_BOUNDS (int)(sizeof(phase_bounds_ns) / sizeof(phase_bounds_ns[0]))
+
+static void emit(struct metrics_writer *w, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+static void emit(struct metrics_writer *w, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(w->p, w->end - w->p, format, args);
+    va_end(args);
+    if (n < 0 || n >= w->end - w->p)
+    {
+        w->truncated = 1;
+        w->p = w->end;
+        return;
+    }
+    w->p += n;
+}
+
+static void emit_metric(struct metrics_writer *w, const char *name, const char *type, const char *help)
+{
+    emit(w, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+// A temperature the sensor could not provide reads NaN rather than -1
+static void emit_temperature(struct metrics_writer *w, const char *series, float celsius)
+{
+    if (celsius < 0)
+    {
+        emit(w, "%s NaN\n", series);
+    }
+    else
+    {
+        emit(w, "%s %.2f\n", series, celsius);
+    }
+}
+
+static void emit_phases(struct metrics_writer *w)
+{
+    uint64_t cumulative[PHASE_BOUNDS];
+
+    emit_metric(w, "drier_phase_duration_seconds", "histogram",
+                "Control-loop phase durations; jitter is the tick period's distance from nominal");
+    for (int i = 0; i < LATENCY_PHASES; i++)
+    {
+        const struct histogram *h = &latency_phases[i];
+        const char *phase = latency_phase_names[i];
+        uint64_t total = atomic_load_explicit(&h->total, memory_order_relaxed);
+        uint64_t sum = atomic_load_explicit(&h->sum, memory_order_relaxed);
+
+        histogram_cumulative(h, phase_bounds_ns, PHASE_BOUNDS, cumulative);
+        for (int b = 0; b < PHASE_BOUNDS; b++)
+        {
+            // A reader racing the control thread can see a bucket ahead of the total
+            emit(w, "drier_phase_duration_seconds_bucket{phase=\"%s\",le=\"%s\"} %llu\n", phase, phase_bounds_le[b],
+                 (unsigned long long)(cumulative[b] < total ? cumulative[b] : total));
+        }
+        emit(w, "drier_phase_duration_seconds_bucket{phase=\"%s\",le=\"+Inf\"} %llu\n", phase,
+             (unsigned long long)total);
+        emit(w, "drier_phase_duration_seconds_sum{phase=\"%s\"} %.9f\n", phase, sum / 1e9);
+        emit(w, "drier_phase_duration_seconds_count{phase=\"%s\"} %llu\n", phase, (unsigned long long)total);
+    }
+}
+
+static void emit_zones(struct metrics_writer *w, const struct zone_table *zones)
+{
+    char series[64];
+
+    emit_metric(w, "drier_zone_temperature_celsius", "gauge", "Latest zone temperature; NaN without a valid reading");
+    for (int i = 0; i < zones->count; i++)
+    {
+        snprintf(series, sizeof(series), "drier_zone_temperature_celsius{zone=\"%d\"}", i);
+        emit_temperature(w, series, zones->current_temp[i]);
+    }
+    emit_metric(w, "drier_zone_desired_temperature_celsius", "gauge", "Zone setpoint");
+    for (int i = 0; i < zones->count; i++)
+    {
+        emit(w, "drier_zone_desired_temperature_celsius{zone=\"%d\"} %.2f\n", i, zones->desired_temp[i]);
+    }
+    emit_metric(w, "drier_zone_heater_duty_ratio", "gauge", "Zone heater duty, 0 to 1");
+    for (int i = 0; i < zones->count; i++)
+    {
+        emit(w, "drier_zone_heater_duty_ratio{zone=\"%d\"} %.3f\n", i, zones->duty[i]);
+    }
+}
+
+// The exposition text for `drier`, or for `zones` when given, into
+// `buffer`. Returns its length, or -1 if it did not fit, counted in
+// metrics_stats; a scraper must never get a partial series.
+int metrics_format(char *buffer, size_t size, struct drier *drier, const struct zone_table *zones)
+{
+    struct metrics_writer w = {buffer, buffer + size, 0};
+
+    emit_metric(&w, "drier_uptime_seconds", "gauge", "Seconds since the daemon started");
+    emit(&w, "drier_uptime_seconds %.3f\n", (monotonic_ns() - started_ns) / 1e9);
+
+    if (zones)
+    {
+        emit_zones(&w, zones);
+    }
+    else
+    {
+        emit_metric(&w, "drier_temperature_celsius", "gauge", "Latest filtered temperature; NaN without a valid reading");
+        emit_temperature(&w, "drier_temperature_celsius", sampler_latest_temperature(drier));
+        emit_metric(&w, "drier_desired_temperature_celsius", "gauge", "Current setpoint");
+        emit(&w, "drier_desired_temperature_celsius %.2f\n", drier->desired_temp);
+        emit_metric(&w, "drier_heater_on", "gauge", "1 while the heater output is on");
+        emit(&w, "drier_heater_on %d\n", drier->heater_state ? 1 : 0);
+        emit_metric(&w, "drier_heater_duty_ratio", "gauge", "Commanded heater duty, 0 to 1");
+        emit(&w, "drier_heater_duty_ratio %.3f\n", drier->heater_duty);
+    }
+    emit_metric(&w, "drier_sensor_invalid_readings_total", "counter",
+                "Sensor reads rejected as invalid, e.g. an out-of-range voltage");
+    emit(&w, "drier_sensor_invalid_readings_total %lu\n", atomic_load(&drier->sensor_invalid_readings));
+
+    emit_metric(&w, "drier_safety_cutoff_active", "gauge", "1 while an interlock or the watchdog holds the heaters off");
+    emit(&w, "drier_safety_cutoff_active %d\n", atomic_load(&safety_active) ? 1 : 0);
+    emit_metric(&w, "drier_safety_trips_total", "counter", "Hardware interlock trips");
+    emit(&w, "drier_safety_trips_total %lu\n", atomic_load(&safety_stats.trips));
+    emit_metric(&w, "drier_control_cycles_total", "counter", "Control ticks completed");
+    emit(&w, "drier_control_cycles_total %lu\n", atomic_load(&watchdog_stats.cycles));
+    emit_metric(&w, "drier_watchdog_missed_deadlines_total", "counter", "Control ticks the watchdog saw overrun");
+    emit(&w, "drier_watchdog_missed_deadlines_total %lu\n", atomic_load(&watchdog_stats.missed));
+    emit_metric(&w, "drier_cycle_worst_seconds", "gauge", "Longest control tick so far");
+    emit(&w, "drier_cycle_worst_seconds %.6f\n", atomic_load(&watchdog_stats.worst_cycle_ns) / 1e9);
+    emit_phases(&w);
+
+    if (w.truncated)
+    {
+        metrics_stats.truncated++;
+        return -1;
+    }
+    return w.p - buffer;
+}
+
+static void close_connection(struct metrics_connection *c)
+{
+    epoll_ctl(metrics_epoll, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    c->fd = -1;
+}
+
+// Put the reply for the request in `c` in its response buffer. The body
+// is formatted first, just past the space reserved for the header, so
+// the header can be written in front of it without moving the body.
+static void build_response(struct metrics_connection *c)
+{
+    char *body = c->response + METRICS_HEADER_SIZE;
+    size_t body_size = response_size - METRICS_HEADER_SIZE;
+    const char *status = "200 OK";
+    int body_length;
+
+    if (strncmp(c->request, "GET /metrics ", 13) == 0 || strncmp(c->request, "GET /metrics?", 13) == 0)
+    {
+        metrics_stats.scrapes++;
+        body_length = metrics_format(body, body_size, metrics_drier, metrics_zones);
+        if (body_length < 0)
+        {
+            status = "500 Internal Server Error";
+            body_length = snprintf(body, body_size, "%s: metrics do not fit the response buffer\n", status);
+        }
+    }
+    else
+    {
+        metrics_stats.rejected++;
+        status = strncmp(c->request, "GET ", 4) == 0 ? "404 Not Found" : "405 Method Not Allowed";
+        body_length = snprintf(body, body_size, "%s\n", status);
+    }
+
+    char header[METRICS_HEADER_SIZE];
+    int header_length = snprintf(header, sizeof(header),
+                                 "HTTP/1.1 %s\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                                 "Content-Length: %d\r\nConnection: close\r\n\r\n",
+                                 status, body_length);
+    c->start = METRICS_HEADER_SIZE - header_length;
+    c->length = header_length + body_length;
+    memcpy(c->response + c->start, header, header_length);
+}
+
+// Send what the socket takes; the rest waits for EPOLLOUT. The connection
+// closes once everything is out.
+static void send_response(struct metrics_connection *c)
+{
+    while (c->length > 0)
+    {
+        ssize_t n = send(c->fd, c->response + c->start, c->length, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n < 0 && errno == EAGAIN)
+        {
+            struct epoll_event ev = {.events = EPOLLOUT, .data.ptr = c};
+            epoll_ctl(metrics_epoll, EPOLL_CTL_MOD, c->fd, &ev);
+            return;
+        }
+        if (n < 0)
+        {
+            break;
+        }
+        c->start += n;
+        c->length -= n;
+    }
+    close_connection(c);
+}
+
+// Requests are answered once the blank line ending the headers arrives;
+// anything else (bodies, pipelining, keep-alive) is not needed by a scraper
+static void read_request(struct metrics_connection *c)
+{
+    ssize_t n = recv(c->fd, c->request + c->request_length, sizeof(c->request) - 1 - c->request_length, MSG_DONTWAIT);
+    if (n < 0 && (errno == EAGAIN || errno == EINTR))
+    {
+        return;
+    }
+    if (n <= 0)
+    {
+        close_connection(c);
+        return;
+    }
+    c->request_length += n;
+    c->request[c->request_length] = '\0';
+
+    if (strstr(c->request, "\r\n\r\n") || strstr(c->request, "\n\n"))
+    {
+        build_response(c);
+        send_response(c);
+    }
+    else if (c->request_length == sizeof(c->request) - 1)
+    {
+        metrics_stats.rejected++;
+        close_connection(c);
+    }
+}
+
+// One connection per call; the listener stays ready for the rest
+static void accept_connection(void)
+{
+    int fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    // A full table gives up the slot of its oldest client if that one
+    // stalled; otherwise the newcomer is turned away
+    int64_t now = monotonic_ns();
+    struct metrics_connection *c = &connections[0];
+    for (int i = 0; i < METRICS_MAX_CONNECTIONS; i++)
+    {
+        if (connections[i].fd < 0)
+        {
+            c = &connections[i];
+            break;
+        }
+        if (connections[i].accepted_ns < c->accepted_ns)
+        {
+            c = &connections[i];
+        }
+    }
+    if (c->fd >= 0 && now - c->accepted_ns < METRICS_STALL_NS)
+    {
+        metrics_stats.refused++;
+        close(fd);
+        return;
+    }
+    if (c->fd >= 0)
+    {
+        metrics_stats.evicted++;
+        close_connection(c);
+    }
+
+    struct epoll_event ev = {.events = EPOLLIN, .data.ptr = c};
+    if (epoll_ctl(metrics_epoll, EPOLL_CTL_ADD, fd, &ev) < 0)
+    {
+        close(fd);
+        return;
+    }
+    c->fd = fd;
+    c->accepted_ns = now;
+    c->request_length = 0;
+}
+
+// Parse "[ADDRESS:]PORT" into an IPv4 socket address
+static int parse_address(const char *text, struct sockaddr_in *addr)
+{
+    char host[INET_ADDRSTRLEN] = "127.0.0.1";
+    const char *colon = strrchr(text, ':');
+    int port = atoi(colon ? colon + 1 : text);
+
+    if (colon)
+    {
+        if ((size_t)(colon - text) >= sizeof(host))
+        {
+            return -1;
+        }
+        memcpy(host, text, colon - text);
+        host[colon - text] = '\0';
+    }
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(port);
+    return port > 0 && port < 65536 && inet_pton(AF_INET, host, &addr->sin_addr) == 1 ? 0 : -1;
+}
+
+// Listen for scrapes of `drier` on `address`, "[ADDRESS:]PORT" with the
+// address defaulting to loopback. `zones` selects per-zone gauges instead
+// of the single drier's. Returns a descriptor for the caller's event loop
+// that is readable whenever metrics_service() has work, or -1.
+int metrics_start(const char *address, struct drier *drier, const struct zone_table *zones)
+{
+    struct sockaddr_in addr = {0};
+    if (parse_address(address, &addr) < 0)
+    {
+        log_error("Bad metrics address '%s', expected [ADDRESS:]PORT", address);
+        return -1;
+    }
+
+    // Zones are fixed once the daemon runs, so the buffers never grow
+    response_size = METRICS_RESPONSE_SIZE + (zones ? (size_t)zones->count * METRICS_ZONE_SIZE : 0);
+    for (int i = 0; i < METRICS_MAX_CONNECTIONS; i++)
+    {
+        connections[i].fd = -1;
+        connections[i].response = malloc(response_size);
+        if (!connections[i].response)
+        {
+            log_error("Cannot allocate %zu byte metrics buffers", response_size);
+            metrics_stop();
+            return -1;
+        }
+    }
+    metrics_drier = drier;
+    metrics_zones = zones;
+    started_ns = monotonic_ns();
+
+    int reuse = 1;
+    listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    metrics_epoll = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event ev = {.events = EPOLLIN, .data.ptr = NULL};
+    if (listen_fd < 0 || metrics_epoll < 0 ||
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0 ||
+        bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, METRICS_BACKLOG) < 0 ||
+        epoll_ctl(metrics_epoll, EPOLL_CTL_ADD, listen_fd, &ev) < 0)
+    {
+        log_error("Cannot serve metrics on %s: %s", address, strerror(errno));
+        metrics_stop();
+        return -1;
+    }
+    char host[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &addr.sin_addr, host, sizeof(host));
+    log_info("Serving metrics on http://%s:%d/metrics", host, ntohs(addr.sin_port));
+    return metrics_epoll;
+}
+
+// Safe to call when metrics_start never ran or failed part way: the
+// connection slots only hold descriptors while the epoll instance exists
+void metrics_stop(void)
+{
+    if (listen_fd >= 0)
+    {
+        close(listen_fd);
+        listen_fd = -1;
+    }
+    if (metrics_epoll >= 0)
+    {
+        for (int i = 0; i < METRICS_MAX_CONNECTIONS; i++)
+        {
+            if (connections[i].fd >= 0)
+            {
+                close_connection(&connections[i]);
+            }
+        }
+        close(metrics_epoll);
+        metrics_epoll = -1;
+    }
+    for (int i = 0; i < METRICS_MAX_CONNECTIONS; i++)
+    {
+        free(connections[i].response);
+        connections[i].response = NULL;
+    }
+}
+
+// Handle one ready event without waiting, so each call formats at most
+// one response. Anything else still ready keeps the descriptor readable
+// and the caller's next epoll_wait returns it again, alongside whatever
+// timers are due by then.
+void metrics_service(void)
+{
+    struct epoll_event event;
+    if (epoll_wait(metrics_epoll, &event, 1, 0) != 1)
+    {
+        return;
+    }
+    struct metrics_connection *c = event.data.ptr;
+    if (!c)
+    {
+        accept_connection();
+    }
+    else if (c->fd >= 0 && (event.events & EPOLLOUT))
+    {
+        send_response(c);
+    }
+    else if (c->fd >= 0)
+    {
+        read_request(c);
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "zones.h"
+
+// Prometheus text exposition over a minimal HTTP/1.1 server: GET /metrics
+// answers with the current readings and counters, then the connection
+// closes. Everything is formatted into buffers allocated at start, sized
+// for the zones being served.
+
+// Constants
+#define METRICS_DEFAULT_ADDRESS "127.0.0.1:9464" // Loopback unless told otherwise
+#define METRICS_MAX_CONNECTIONS 4    // Beyond this, new ones are refused unless one stalled
+#define METRICS_REQUEST_SIZE 1024    // Request line and headers; larger requests are refused
+#define METRICS_HEADER_SIZE 160      // Room reserved for the response header
+#define METRICS_RESPONSE_SIZE 32768  // Header plus body, before any zones
+#define METRICS_ZONE_SIZE 256        // Body per zone: its three gauge lines, with room to spare
+
+// Struct definitions
+struct metrics_stats
+{
+    unsigned long scrapes;
+    unsigned long rejected;          // Not GET /metrics, or malformed
+    unsigned long refused;           // METRICS_MAX_CONNECTIONS busy
+    unsigned long evicted;           // Stalled, dropped for a newer connection
+    unsigned long truncated;         // Body did not fit; answered with an error instead
+};
+
+// Global variables
+extern struct metrics_stats metrics_stats;
+
+// Function declarations
+int metrics_start(const char *address, struct drier *drier, const struct zone_table *zones);
+void metrics_stop(void);
+void metrics_service(void);
+int metrics_format(char *buffer, size_t size, struct drier *drier, const struct zone_table *zones);
+
+#endif /* METRICS_H */
@@ -0,0 +1,148 @@
+#include <string.h>
+#include "hal.h"
+#include "output.h"
+#include "safety.h"
+
+// A tripped interlock (safety.c) holds every heater off. It cuts pins
+// behind our back, so "on" is always rewritten, and re-checked afterwards
+// in case it tripped between the first check and our write.
+static void output_write(struct output_stage *out, int level)
+{
+    if (atomic_load(&safety_active))
+    {
+        level = 0;
+    }
+    if (level != out->level || level)
+    {
+        hal_heater_write(out->pin, level);
+        out->level = level;
+        if (level && atomic_load(&safety_active))
+        {
+            hal_heater_write(out->pin, 0);
+            out->level = 0;
+        }
+    }
+}
+
+void output_init(struct output_stage *out, int pin, int mode)
+{
+    out->pin = pin;
+    out->mode = mode;
+    out->duty = 0;
+    out->level = 0;
+    out->window_start = 0;
+    out->accumulator = 0;
+
+    hal_pin_mode(pin, HAL_OUTPUT);
+    hal_heater_write(pin, 0);
+    if (mode == OUTPUT_PWM)
+    {
+        hal_heater_pwm(pin, 0);
+    }
+}
+
+// Command a new duty. Anything that is not a valid fraction is treated as
+// a fault and turns the heater off.
+void output_set_duty(struct output_stage *out, float duty, double now)
+{
+    if (!(duty > 0))
+    {
+        duty = 0;
+    }
+    else if (duty > 1)
+    {
+        duty = 1;
+    }
+    out->duty = duty;
+
+    switch (out->mode)
+    {
+    case OUTPUT_PWM:
+        if (atomic_load(&safety_active))
+        {
+            duty = 0;
+        }
+        hal_heater_pwm(out->pin, duty);
+        if (duty > 0 && atomic_load(&safety_active))
+        {
+            hal_heater_pwm(out->pin, 0);
+            duty = 0;
+        }
+        out->level = duty > 0;
+        break;
+    case OUTPUT_TIME_PROPORTIONAL:
+        // Cut immediately on zero, otherwise apply at the next edge
+        if (duty == 0)
+        {
+            output_write(out, 0);
+        }
+        output_service(out, now);
+        break;
+    default:
+        // Called once per control cycle: first-order sigma-delta
+        out->accumulator += duty;
+        if (out->accumulator >= 1.0f)
+        {
+            out->accumulator -= 1.0f;
+            output_write(out, 1);
+        }
+        else
+        {
+            output_write(out, 0);
+        }
+        break;
+    }
+}
+
+// Switch the pin for the current point in the time-proportioning window.
+// Returns when it next needs to be called, or -1 if it does not.
+double output_service(struct output_stage *out, double now)
+{
+    if (out->mode != OUTPUT_TIME_PROPORTIONAL)
+    {
+        return -1;
+    }
+
+    // Edges are compared with a little slack so rounding in the caller's
+    // clock can never leave an edge that is due but not yet reached
+    if (now - out->window_start >= OUTPUT_WINDOW - OUTPUT_EPSILON || now < out->window_start)
+    {
+        out->window_start = now;
+    }
+
+    double on_time = out->duty * OUTPUT_WINDOW;
+    if (on_time < OUTPUT_MIN_SWITCH)
+    {
+        on_time = 0;
+    }
+    else if (on_time > OUTPUT_WINDOW - OUTPUT_MIN_SWITCH)
+    {
+        on_time = OUTPUT_WINDOW;
+    }
+
+    double elapsed = now - out->window_start;
+    if (elapsed < on_time - OUTPUT_EPSILON)
+    {
+        output_write(out, 1);
+        return out->window_start + on_time;
+    }
+    output_write(out, 0);
+    return out->window_start + OUTPUT_WINDOW;
+}
+
+int output_parse_mode(const char *name)
+{
+    if (strcmp(name, "switched") == 0)
+    {
+        return OUTPUT_SWITCHED;
+    }
+    if (strcmp(name, "pwm") == 0)
+    {
+        return OUTPUT_PWM;
+    }
+    if (strcmp(name, "window") == 0)
+    {
+        return OUTPUT_TIME_PROPORTIONAL;
+    }
+    return -1;
+}
@@ -0,0 +1,29 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+// Constants
+#define OUTPUT_SWITCHED 0          // Plain on/off pin, duty spread over control cycles
+#define OUTPUT_PWM 1               // pigpio PWM for SSR/MOSFET drivers
+#define OUTPUT_TIME_PROPORTIONAL 2 // Slow on/off window for zero-cross relays
+#define OUTPUT_WINDOW 10.0         // Time-proportioning window in seconds
+#define OUTPUT_MIN_SWITCH 0.5      // Shorter on or off pulses are not worth a relay cycle
+#define OUTPUT_EPSILON 1e-6        // Timing slack in seconds
+
+// Struct definitions
+struct output_stage
+{
+    int pin;
+    int mode;
+    float duty;          // Commanded duty, 0..1
+    int level;           // Current pin level in the switched modes
+    double window_start; // Start of the current time-proportioning window
+    float accumulator;   // Sigma-delta state for OUTPUT_SWITCHED
+};
+
+// Function declarations
+void output_init(struct output_stage *out, int pin, int mode);
+void output_set_duty(struct output_stage *out, float duty, double now);
+double output_service(struct output_stage *out, double now);
+int output_parse_mode(const char *name);
+
+#endif /* OUTPUT_H */
@@ -0,0 +1,193 @@
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include "log.h"
+#include "pid.h"
+
+void pid_init(struct pid *pid, float kp, float ki, float kd)
+{
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+    pid_reset(pid);
+}
+
+void pid_reset(struct pid *pid)
+{
+    pid->integral = 0;
+    pid->prev_measurement = 0;
+    pid->initialized = 0;
+}
+
+// One PID step on bare state, so callers can keep PID state in their own
+// layout (see zones.c). Returns the heater duty in 0..1.
+float pid_compute(float kp, float ki, float kd, float *integral, float *prev_measurement,
+                  int *initialized, float setpoint, float measurement, float dt)
+{
+    float error = setpoint - measurement;
+
+    // Derivative on measurement so setpoint changes do not kick the output
+    float derivative = 0;
+    if (*initialized && dt > 0)
+    {
+        derivative = -(measurement - *prev_measurement) / dt;
+    }
+    *prev_measurement = measurement;
+    *initialized = 1;
+
+    float proportional = kp * error;
+    float candidate = *integral + ki * error * dt;
+    float output = proportional + candidate + kd * derivative;
+
+    // Anti-windup: only integrate while the output is not saturated in the
+    // direction the error is pushing it (conditional integration)
+    if ((output > 1.0f && error > 0) || (output < 0.0f && error < 0))
+    {
+        output = proportional + *integral + kd * derivative;
+    }
+    else
+    {
+        *integral = candidate;
+    }
+
+    // The integral alone never needs to exceed full scale
+    if (*integral > 1.0f)
+    {
+        *integral = 1.0f;
+    }
+    else if (*integral < 0.0f)
+    {
+        *integral = 0.0f;
+    }
+
+    if (output > 1.0f)
+    {
+        return 1.0f;
+    }
+    if (output < 0.0f)
+    {
+        return 0.0f;
+    }
+    return output;
+}
+
+// One PID step. Returns the heater duty in 0..1.
+float pid_update(struct pid *pid, float setpoint, float measurement, float dt)
+{
+    return pid_compute(pid->kp, pid->ki, pid->kd, &pid->integral, &pid->prev_measurement,
+                       &pid->initialized, setpoint, measurement, dt);
+}
+
+int pid_load_gains(const char *path, float *kp, float *ki, float *kd)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        return -1;
+    }
+    int count = fscanf(file, "%f %f %f", kp, ki, kd);
+    fclose(file);
+    return count == 3 ? 0 : -1;
+}
+
+int pid_save_gains(const char *path, float kp, float ki, float kd)
+{
+    FILE *file = fopen(path, "w");
+    if (!file)
+    {
+        log_error("Failed to save PID gains: %s", strerror(errno));
+        return -1;
+    }
+    fprintf(file, "%f %f %f\n", kp, ki, kd);
+    return fclose(file) == 0 ? 0 : -1;
+}
+
+void autotune_start(struct autotune *tune, float setpoint, double now)
+{
+    tune->setpoint = setpoint;
+    tune->output = 1;
+    tune->start_time = now;
+    tune->last_rise = -1;
+    tune->peak_high = setpoint;
+    tune->peak_low = setpoint;
+    tune->cycles = 0;
+    tune->period_sum = 0;
+    tune->amplitude_sum = 0;
+    tune->done = 0;
+}
+
+// Feed one measurement, returns the relay output to apply (0 or 1)
+int autotune_step(struct autotune *tune, float measurement, double now)
+{
+    if (tune->done)
+    {
+        return 0;
+    }
+    if (now - tune->start_time > AUTOTUNE_TIMEOUT)
+    {
+        log_warn("Autotune did not converge, giving up");
+        tune->done = -1;
+        return 0;
+    }
+
+    if (measurement > tune->peak_high)
+    {
+        tune->peak_high = measurement;
+    }
+    if (measurement < tune->peak_low)
+    {
+        tune->peak_low = measurement;
+    }
+
+    if (tune->output && measurement > tune->setpoint + AUTOTUNE_HYSTERESIS)
+    {
+        tune->output = 0;
+        tune->peak_low = measurement;
+    }
+    else if (!tune->output && measurement < tune->setpoint - AUTOTUNE_HYSTERESIS)
+    {
+        tune->output = 1;
+
+        // A full period ends at each off->on switch; the first one includes
+        // the warm-up from ambient and is not representative
+        if (tune->last_rise >= 0)
+        {
+            tune->cycles++;
+            if (tune->cycles > 1)
+            {
+                tune->period_sum += now - tune->last_rise;
+                tune->amplitude_sum += (tune->peak_high - tune->peak_low) / 2;
+            }
+            if (tune->cycles > AUTOTUNE_CYCLES)
+            {
+                tune->done = 1;
+                tune->output = 0;
+            }
+        }
+        tune->last_rise = now;
+        tune->peak_high = measurement;
+    }
+    return tune->output;
+}
+
+// Gains from the relay experiment. Returns -1 if it did not complete.
+int autotune_gains(const struct autotune *tune, float *kp, float *ki, float *kd)
+{
+    if (tune->done != 1 || tune->amplitude_sum <= 0)
+    {
+        return -1;
+    }
+
+    int samples = tune->cycles - 1;
+    float period = tune->period_sum / samples;
+    float amplitude = tune->amplitude_sum / samples;
+
+    // Ultimate gain of a 0..1 relay (amplitude d = 0.5): Ku = 4d / (pi a)
+    float ku = 4 * 0.5f / (3.14159265f * amplitude);
+
+    // Ziegler-Nichols "no overshoot" rule: overshoot is what warps PLA
+    *kp = 0.2f * ku;
+    *ki = 0.4f * ku / period;
+    *kd = 0.0667f * ku * period;
+    return 0;
+}
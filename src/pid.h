@@ -0,0 +1,49 @@
+#ifndef PID_H
+#define PID_H
+
+// Constants
+#define AUTOTUNE_HYSTERESIS 0.5 // Relay switching band around the setpoint
+#define AUTOTUNE_CYCLES 5       // Oscillation periods averaged, after the first
+#define AUTOTUNE_TIMEOUT 14400  // Give up after four hours without convergence
+
+// Struct definitions
+struct pid
+{
+    float kp;
+    float ki;
+    float kd;
+    float integral;         // Integral term, already scaled by ki
+    float prev_measurement; // For derivative-on-measurement
+    int initialized;
+};
+
+// Åström–Hägglund relay experiment: the heater is switched fully on below
+// the setpoint and fully off above it, and the resulting limit cycle gives
+// the ultimate gain and period of the plant.
+struct autotune
+{
+    float setpoint;
+    int output;             // Current relay state, 0 or 1
+    double start_time;
+    double last_rise;       // Time of the last off->on switch
+    float peak_high;        // Extremes since the last switch
+    float peak_low;
+    int cycles;             // Completed periods, the first is discarded
+    double period_sum;
+    float amplitude_sum;
+    int done;
+};
+
+// Function declarations
+void pid_init(struct pid *pid, float kp, float ki, float kd);
+void pid_reset(struct pid *pid);
+float pid_compute(float kp, float ki, float kd, float *integral, float *prev_measurement,
+                  int *initialized, float setpoint, float measurement, float dt);
+float pid_update(struct pid *pid, float setpoint, float measurement, float dt);
+int pid_load_gains(const char *path, float *kp, float *ki, float *kd);
+int pid_save_gains(const char *path, float kp, float ki, float kd);
+void autotune_start(struct autotune *tune, float setpoint, double now);
+int autotune_step(struct autotune *tune, float measurement, double now);
+int autotune_gains(const struct autotune *tune, float *kp, float *ki, float *kd);
+
+#endif /* PID_H */
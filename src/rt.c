@@ -0,0 +1,92 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "log.h"
+#include "rt.h"
+
+// Global variables
+int rt_priority = 0;
+int rt_cpu = -1;
+
+// First CPU the kernel keeps the scheduler off (isolcpus=), or -1
+int rt_isolated_cpu(void)
+{
+    FILE *file = fopen(RT_ISOLATED_CPUS, "r");
+    if (!file)
+    {
+        return -1;
+    }
+    int cpu;
+    if (fscanf(file, "%d", &cpu) != 1)
+    {
+        cpu = -1;
+    }
+    fclose(file);
+    return cpu;
+}
+
+// Lock every current and future page in RAM, and keep malloc from
+// handing memory back to the kernel or using mmap, so a later allocation
+// cannot page-fault. Call once, before the real-time threads start.
+int rt_lock_memory(void)
+{
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) < 0)
+    {
+        log_warn("Cannot lock memory: %s", strerror(errno));
+        return -1;
+    }
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+    return 0;
+}
+
+// Touch the stack the thread will use, so its pages are resident (and,
+// after rt_lock_memory(), locked) before the first deadline
+static void prefault_stack(void)
+{
+    volatile unsigned char stack[RT_STACK_PREFAULT];
+    for (size_t i = 0; i < sizeof(stack); i += 4096)
+    {
+        stack[i] = 0;
+    }
+}
+
+// Move the calling thread to SCHED_FIFO at rt_priority and pin it to
+// rt_cpu. A no-op with rt_priority 0. Threads it creates afterwards would
+// inherit this, so helpers that must stay at normal priority are started
+// first or set their own policy.
+int rt_enter(void)
+{
+    if (rt_priority <= 0)
+    {
+        return 0;
+    }
+
+    if (rt_cpu >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(rt_cpu, &cpus);
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (err)
+        {
+            log_warn("Cannot pin to CPU %d: %s", rt_cpu, strerror(err));
+            return -1;
+        }
+    }
+
+    struct sched_param param = {.sched_priority = rt_priority};
+    int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (err)
+    {
+        log_warn("Cannot run at SCHED_FIFO priority %d: %s", rt_priority, strerror(err));
+        return -1;
+    }
+    prefault_stack();
+    return 0;
+}
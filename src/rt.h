@@ -0,0 +1,20 @@
+#ifndef RT_H
+#define RT_H
+
+// Opt-in real-time mode for the control and sampling threads
+
+// Constants
+#define RT_DEFAULT_PRIORITY 50          // SCHED_FIFO; the watchdog monitor (80) still preempts it
+#define RT_STACK_PREFAULT (256 * 1024)  // Stack touched up front by each real-time thread
+#define RT_ISOLATED_CPUS "/sys/devices/system/cpu/isolated"
+
+// Global variables
+extern int rt_priority; // 0 keeps normal scheduling
+extern int rt_cpu;      // -1 leaves the thread unpinned
+
+// Function declarations
+int rt_isolated_cpu(void);
+int rt_lock_memory(void);
+int rt_enter(void);
+
+#endif /* RT_H */
@@ -0,0 +1,110 @@
+#include "hal.h"
+#include "safety.h"
+
+// Global variables
+_Atomic int safety_active = 0;
+struct safety_stats safety_stats;
+
+static int heater_pins[SAFETY_MAX_HEATERS];
+static _Atomic int heater_count = 0;
+
+// Heater pins the interlock cuts; may be called at any time
+void safety_protect(int heater_pin)
+{
+    int count = atomic_load(&heater_count);
+    for (int i = 0; i < count; i++)
+    {
+        if (heater_pins[i] == heater_pin)
+        {
+            return;
+        }
+    }
+    if (count < SAFETY_MAX_HEATERS)
+    {
+        heater_pins[count] = heater_pin;
+        atomic_store(&heater_count, count + 1);
+    }
+}
+
+static int input_bit(int pin)
+{
+    return pin == SAFETY_THERMOSTAT_PIN ? SAFETY_OVER_TEMP : pin == SAFETY_LID_PIN ? SAFETY_LID_OPEN : 0;
+}
+
+static void record_latency(uint32_t latency)
+{
+    atomic_store(&safety_stats.last_latency_us, latency);
+    atomic_fetch_add(&safety_stats.total_latency_us, latency);
+    if (latency > atomic_load(&safety_stats.worst_latency_us))
+    {
+        atomic_store(&safety_stats.worst_latency_us, latency);
+    }
+}
+
+static void cut_heaters(void)
+{
+    int count = atomic_load(&heater_count);
+    for (int i = 0; i < count; i++)
+    {
+        hal_heater_write(heater_pins[i], 0);
+    }
+}
+
+// Assert a trip source from any thread: every protected heater is written
+// low now and held low until safety_clear(bit)
+void safety_trip(int bit)
+{
+    atomic_fetch_or(&safety_active, bit);
+    cut_heaters();
+}
+
+void safety_clear(int bit)
+{
+    atomic_fetch_and(&safety_active, ~bit);
+}
+
+// Edge callback, on the HAL's alert thread. Cuts every protected heater
+// before anything else, independently of the control loop, which only
+// finds out through safety_active and can no longer switch a heater on.
+void safety_edge(int pin, int level, uint32_t tick_us)
+{
+    int bit = input_bit(pin);
+    if (!bit || (level != 0 && level != 1))
+    {
+        // Not ours, or a watchdog timeout report
+        return;
+    }
+
+    if (level == SAFETY_ACTIVE_LEVEL)
+    {
+        safety_trip(bit);
+
+        // Unsigned arithmetic copes with the microsecond tick wrapping
+        record_latency(hal_micros() - tick_us);
+        atomic_fetch_add(&safety_stats.trips, 1);
+    }
+    else
+    {
+        safety_clear(bit);
+    }
+}
+
+// Watch the thermostat and lid inputs. Returns -1 if they cannot be.
+int safety_init(void)
+{
+    int pins[] = {SAFETY_THERMOSTAT_PIN, SAFETY_LID_PIN};
+    for (int i = 0; i < 2; i++)
+    {
+        if (hal_watch_input(pins[i], safety_edge) < 0)
+        {
+            return -1;
+        }
+
+        // An input already asserted at startup keeps the heaters off
+        if (hal_read_input(pins[i]) == SAFETY_ACTIVE_LEVEL)
+        {
+            atomic_fetch_or(&safety_active, input_bit(pins[i]));
+        }
+    }
+    return 0;
+}
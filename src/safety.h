@@ -0,0 +1,39 @@
+#ifndef SAFETY_H
+#define SAFETY_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Constants
+#define SAFETY_THERMOSTAT_PIN 27 // GPIO27: over-temperature comparator/thermostat, low when tripped
+#define SAFETY_LID_PIN 22        // GPIO22: lid switch, low when the lid is open
+#define SAFETY_ACTIVE_LEVEL 0    // Both inputs pull up and are switched to ground
+#define SAFETY_MAX_HEATERS 512
+
+// Trip sources, as bits of safety_active
+#define SAFETY_OVER_TEMP 1
+#define SAFETY_LID_OPEN 2
+#define SAFETY_WATCHDOG 4 // Control loop missed its deadline (watchdog.c)
+
+// Struct definitions
+// Written only by the edge callback thread, read by anyone
+struct safety_stats
+{
+    _Atomic unsigned long trips;
+    _Atomic uint32_t last_latency_us;  // Edge timestamp to heater pins written
+    _Atomic uint32_t worst_latency_us;
+    _Atomic uint64_t total_latency_us;
+};
+
+// Global variables
+extern _Atomic int safety_active; // SAFETY_* bits currently asserted, 0 when safe
+extern struct safety_stats safety_stats;
+
+// Function declarations
+void safety_protect(int heater_pin);
+int safety_init(void);
+void safety_trip(int bit);
+void safety_clear(int bit);
+void safety_edge(int pin, int level, uint32_t tick_us);
+
+#endif /* SAFETY_H */
@@ -0,0 +1,152 @@
+#include "sample_ring.h"
+
+void sample_ring_init(struct sample_ring *ring)
+{
+    atomic_store_explicit(&ring->head, 0, memory_order_relaxed);
+    for (int i = 0; i < SAMPLE_RING_SIZE; i++)
+    {
+        atomic_store_explicit(&ring->slots[i].sequence, 0, memory_order_relaxed);
+    }
+}
+
+// Producer side: never blocks, overwrites the oldest sample when full
+void sample_ring_publish(struct sample_ring *ring, int64_t timestamp_ns, float temperature, float variance)
+{
+    uint64_t index = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    struct sample_slot *slot = &ring->slots[index & SAMPLE_RING_MASK];
+
+    // Odd sequence marks the slot as being written
+    atomic_store_explicit(&slot->sequence, 2 * index + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&slot->timestamp_ns, timestamp_ns, memory_order_relaxed);
+    atomic_store_explicit(&slot->temperature, temperature, memory_order_relaxed);
+    atomic_store_explicit(&slot->variance, variance, memory_order_relaxed);
+
+    atomic_store_explicit(&slot->sequence, 2 * index + 2, memory_order_release);
+    atomic_store_explicit(&ring->head, index + 1, memory_order_release);
+}
+
+// Copy sample `index` out of the ring. Returns 0 if it has been overwritten.
+static int read_slot(struct sample_ring *ring, uint64_t index, struct sample *out)
+{
+    struct sample_slot *slot = &ring->slots[index & SAMPLE_RING_MASK];
+    uint64_t expected = 2 * index + 2;
+
+    if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != expected)
+    {
+        return 0;
+    }
+
+    out->timestamp_ns = atomic_load_explicit(&slot->timestamp_ns, memory_order_relaxed);
+    out->temperature = atomic_load_explicit(&slot->temperature, memory_order_relaxed);
+    out->variance = atomic_load_explicit(&slot->variance, memory_order_relaxed);
+
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&slot->sequence, memory_order_relaxed) == expected;
+}
+
+// Most recent sample. Returns 0 if nothing has been published yet.
+int sample_ring_latest(struct sample_ring *ring, struct sample *out)
+{
+    for (;;)
+    {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (head == 0)
+        {
+            return 0;
+        }
+        if (read_slot(ring, head - 1, out))
+        {
+            return 1;
+        }
+        // Writer lapped us mid-copy; retry with the new head
+    }
+}
+
+// Up to max_samples most recent samples, oldest first. Returns the count.
+int sample_ring_window(struct sample_ring *ring, struct sample *out, int max_samples)
+{
+    if (max_samples > SAMPLE_RING_SIZE - 1)
+    {
+        max_samples = SAMPLE_RING_SIZE - 1;
+    }
+
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint64_t first = head > (uint64_t)max_samples ? head - max_samples : 0;
+    int count = 0;
+
+    for (uint64_t index = first; index < head; index++)
+    {
+        if (read_slot(ring, index, &out[count]))
+        {
+            count++;
+        }
+        else
+        {
+            // Older entries were overwritten while copying; restart from here
+            count = 0;
+        }
+    }
+    return count;
+}
+
+// Next unread sample for a consumer-owned cursor. Skips ahead if the
+// producer has overrun the cursor. Returns 0 when caught up.
+int sample_ring_consume(struct sample_ring *ring, uint64_t *cursor, struct sample *out)
+{
+    for (;;)
+    {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (*cursor >= head)
+        {
+            return 0;
+        }
+        if (head - *cursor > SAMPLE_RING_SIZE - 1)
+        {
+            *cursor = head - (SAMPLE_RING_SIZE - 1);
+        }
+        if (read_slot(ring, *cursor, out))
+        {
+            (*cursor)++;
+            return 1;
+        }
+        (*cursor)++;
+    }
+}
+
+// Single-slot variant for producers whose readers only want the newest
+// value, e.g. one slot per zone. Same sequence protocol, with the slot's
+// own count in place of the ring index.
+void sample_slot_publish(struct sample_slot *slot, int64_t timestamp_ns, float temperature, float variance)
+{
+    uint64_t sequence = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+
+    atomic_store_explicit(&slot->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&slot->timestamp_ns, timestamp_ns, memory_order_relaxed);
+    atomic_store_explicit(&slot->temperature, temperature, memory_order_relaxed);
+    atomic_store_explicit(&slot->variance, variance, memory_order_relaxed);
+
+    atomic_store_explicit(&slot->sequence, sequence + 2, memory_order_release);
+}
+
+// Copy the slot out. Returns 0 if nothing was published yet or the writer
+// is mid-update; the caller keeps its previous copy rather than spin, since
+// the writer may be a preempted thread of the same priority.
+int sample_slot_read(struct sample_slot *slot, struct sample *out)
+{
+    uint64_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+    if (sequence == 0 || (sequence & 1))
+    {
+        return 0;
+    }
+
+    out->timestamp_ns = atomic_load_explicit(&slot->timestamp_ns, memory_order_relaxed);
+    out->temperature = atomic_load_explicit(&slot->temperature, memory_order_relaxed);
+    out->variance = atomic_load_explicit(&slot->variance, memory_order_relaxed);
+
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&slot->sequence, memory_order_relaxed) == sequence;
+}
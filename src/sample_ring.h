@@ -0,0 +1,45 @@
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Constants
+#define SAMPLE_RING_SIZE 256 // Must be a power of two
+#define SAMPLE_RING_MASK (SAMPLE_RING_SIZE - 1)
+
+// Struct definitions
+struct sample
+{
+    int64_t timestamp_ns; // CLOCK_MONOTONIC time of acquisition
+    float temperature;    // Negative on sensor failure, like read_temperature()
+    float variance;       // The filter's variance around it, published with it
+};
+
+// One writer, any number of non-blocking readers. Each slot carries a
+// sequence number so a reader can detect that the writer lapped it while
+// it was copying; the writer never waits for readers.
+struct sample_slot
+{
+    _Atomic uint64_t sequence; // 2 * index + 2 once slot holds sample `index`
+    _Atomic int64_t timestamp_ns;
+    _Atomic float temperature;
+    _Atomic float variance;
+};
+
+struct sample_ring
+{
+    _Alignas(64) _Atomic uint64_t head; // Number of samples ever published
+    _Alignas(64) struct sample_slot slots[SAMPLE_RING_SIZE];
+};
+
+// Function declarations
+void sample_ring_init(struct sample_ring *ring);
+void sample_ring_publish(struct sample_ring *ring, int64_t timestamp_ns, float temperature, float variance);
+int sample_ring_latest(struct sample_ring *ring, struct sample *out);
+int sample_ring_window(struct sample_ring *ring, struct sample *out, int max_samples);
+int sample_ring_consume(struct sample_ring *ring, uint64_t *cursor, struct sample *out);
+void sample_slot_publish(struct sample_slot *slot, int64_t timestamp_ns, float temperature, float variance);
+int sample_slot_read(struct sample_slot *slot, struct sample *out);
+
+#endif /* SAMPLE_RING_H */
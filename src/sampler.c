@@ -0,0 +1,94 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "control.h"
+#include "latency.h"
+#include "log.h"
+#include "rt.h"
+#include "sampler.h"
+
+int64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Sleep until the next sampling period after `next`, and advance it.
+// Absolute deadlines so the read time does not stretch the period.
+void sampler_wait(struct timespec *next)
+{
+    next->tv_nsec += SAMPLER_INTERVAL_MS * 1000000L;
+    while (next->tv_nsec >= 1000000000L)
+    {
+        next->tv_nsec -= 1000000000L;
+        next->tv_sec++;
+    }
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, next, NULL);
+}
+
+// Acquisition loop: the blocking sensor retries happen here, off the
+// control path, and every result is published with its timestamp into
+// the drier's sample ring. The filter belongs to this thread, so its
+// variance is published with the reading rather than read elsewhere.
+static void *sampler_main(void *arg)
+{
+    struct drier *d = arg;
+    rt_enter();
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while (atomic_load(&d->sampler_running))
+    {
+        int64_t start = monotonic_ns();
+        float temperature = read_temperature(d);
+        sample_ring_publish(&d->samples, latency_mark(LATENCY_ACQUIRE, start), temperature,
+                            d->temperature_filter.variance);
+
+        sampler_wait(&next);
+    }
+    return NULL;
+}
+
+int sampler_start(struct drier *d)
+{
+    sample_ring_init(&d->samples);
+    atomic_store(&d->sampler_running, 1);
+    if (pthread_create(&d->sampler_thread, NULL, sampler_main, d) != 0)
+    {
+        atomic_store(&d->sampler_running, 0);
+        log_error("Failed to start sampling thread");
+        return -1;
+    }
+    return 0;
+}
+
+void sampler_stop(struct drier *d)
+{
+    if (atomic_exchange(&d->sampler_running, 0))
+    {
+        pthread_join(d->sampler_thread, NULL);
+    }
+}
+
+// Latest published sample. Returns 0 if there is none or it is stale,
+// with the temperature at -1 and no variance.
+int sampler_latest(struct drier *d, struct sample *out)
+{
+    if (!sample_ring_latest(&d->samples, out) ||
+        monotonic_ns() - out->timestamp_ns > SAMPLE_MAX_AGE_MS * 1000000LL)
+    {
+        out->temperature = -1;
+        out->variance = 0;
+        return 0;
+    }
+    return 1;
+}
+
+// Latest published temperature, or -1 if there is none or it is stale
+float sampler_latest_temperature(struct drier *d)
+{
+    struct sample latest;
+    sampler_latest(d, &latest);
+    return latest.temperature;
+}
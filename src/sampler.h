@@ -0,0 +1,20 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <stdint.h>
+#include <time.h>
+#include "control.h"
+
+// Constants
+#define SAMPLER_INTERVAL_MS 500 // Time between published samples
+#define SAMPLE_MAX_AGE_MS 2000  // Older samples are treated as a sensor failure
+
+// Function declarations
+int64_t monotonic_ns(void);
+void sampler_wait(struct timespec *next);
+int sampler_start(struct drier *d);
+void sampler_stop(struct drier *d);
+int sampler_latest(struct drier *d, struct sample *out);
+float sampler_latest_temperature(struct drier *d);
+
+#endif /* SAMPLER_H */
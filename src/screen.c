@@ -0,0 +1,413 @@
+#include <errno.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "screen.h"
+
+#define SCREEN_CLEAR "\033[2J"
+#define SCREEN_SHOW_CURSOR "\033[?25h"
+#define SCREEN_HIDE_CURSOR "\033[?25l"
+#define SCREEN_TEXT_MAX 1024
+
+static const struct screen_cell blank_cell = {" ", 1};
+
+static struct screen_cell *cell_at(struct screen_cell *grid, const struct screen *s, int row, int col)
+{
+    return &grid[(row - 1) * s->cols + (col - 1)];
+}
+
+// Terminal columns taken by a code point: 0 for combining marks and
+// variation selectors, 2 for CJK and emoji, 1 otherwise
+static int codepoint_width(unsigned long cp)
+{
+    if ((cp >= 0x0300 && cp <= 0x036F) || cp == 0x200D || (cp >= 0xFE00 && cp <= 0xFE0F))
+    {
+        return 0;
+    }
+    if ((cp >= 0x1100 && cp <= 0x115F) || (cp >= 0x2E80 && cp <= 0xA4CF) ||
+        (cp >= 0xAC00 && cp <= 0xD7A3) || (cp >= 0xF900 && cp <= 0xFAFF) ||
+        (cp >= 0xFF00 && cp <= 0xFF60) || (cp >= 0xFFE0 && cp <= 0xFFE6) ||
+        (cp >= 0x1F300 && cp <= 0x1FAFF))
+    {
+        return 2;
+    }
+    return 1;
+}
+
+// Length of the UTF-8 sequence at `text` and its code point
+static int utf8_decode(const char *text, unsigned long *cp)
+{
+    const unsigned char *p = (const unsigned char *)text;
+    int length = p[0] < 0x80 ? 1 : p[0] < 0xE0 ? 2 : p[0] < 0xF0 ? 3 : 4;
+
+    *cp = length == 1 ? p[0] : p[0] & (0x3F >> (length - 1));
+    for (int i = 1; i < length; i++)
+    {
+        if ((p[i] & 0xC0) != 0x80)
+        {
+            // Malformed: take the lead byte alone
+            *cp = '?';
+            return 1;
+        }
+        *cp = (*cp << 6) | (p[i] & 0x3F);
+    }
+    return length;
+}
+
+static void fill_blank(struct screen_cell *grid, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        grid[i] = blank_cell;
+    }
+}
+
+// Columns first..last of `row` need comparing at the next flush
+static void mark_dirty(struct screen *s, int row, int first, int last)
+{
+    if (first < s->dirty_first[row - 1])
+    {
+        s->dirty_first[row - 1] = first < 1 ? 1 : first;
+    }
+    if (last > s->dirty_last[row - 1])
+    {
+        s->dirty_last[row - 1] = last > s->cols ? s->cols : last;
+    }
+}
+
+int screen_init(struct screen *s, int rows, int cols)
+{
+    memset(s, 0, sizeof(*s));
+    return screen_resize(s, rows, cols);
+}
+
+// Reallocate for a new terminal size; the next flush repaints everything
+int screen_resize(struct screen *s, int rows, int cols)
+{
+    if (rows < 1 || cols < 1 || rows > SCREEN_MAX_ROWS || cols > SCREEN_MAX_COLS)
+    {
+        return -1;
+    }
+
+    size_t cells = (size_t)rows * cols;
+    // Worst case per cell: a cursor move and a full glyph
+    size_t out_size = cells * (SCREEN_GLYPH_SIZE + 16) + sizeof(SCREEN_CLEAR) + 32;
+    struct screen_cell *front = malloc(cells * sizeof(*front));
+    struct screen_cell *back = malloc(cells * sizeof(*back));
+    char *out = malloc(out_size);
+    int *dirty = malloc(2 * rows * sizeof(*dirty));
+    if (!front || !back || !out || !dirty)
+    {
+        free(front);
+        free(back);
+        free(out);
+        free(dirty);
+        return -1;
+    }
+
+    free(s->front);
+    free(s->back);
+    free(s->out);
+    free(s->dirty_first);
+    s->rows = rows;
+    s->cols = cols;
+    s->front = front;
+    s->back = back;
+    s->out = out;
+    s->dirty_first = dirty;
+    s->dirty_last = dirty + rows;
+    for (int row = 0; row < rows; row++)
+    {
+        s->dirty_first[row] = cols + 1;
+        s->dirty_last[row] = 0;
+    }
+    s->out_size = out_size;
+    screen_clear(s);
+    screen_invalidate(s);
+    return 0;
+}
+
+void screen_free(struct screen *s)
+{
+    free(s->front);
+    free(s->back);
+    free(s->out);
+    free(s->dirty_first);
+    s->front = s->back = NULL;
+    s->out = NULL;
+    s->dirty_first = s->dirty_last = NULL;
+}
+
+// Forget what the terminal shows, e.g. after something else drew on it
+// or a frame only partly reached it
+void screen_invalidate(struct screen *s)
+{
+    s->clear_pending = 1;
+    s->cursor_shown = -1;
+}
+
+// Start a new frame
+void screen_clear(struct screen *s)
+{
+    fill_blank(s->back, s->rows * s->cols);
+    for (int row = 1; row <= s->rows; row++)
+    {
+        mark_dirty(s, row, 1, s->cols);
+    }
+}
+
+// Place UTF-8 text at a 1-based position, clipped to the row. Returns the
+// number of columns it covers.
+int screen_text(struct screen *s, int row, int col, const char *text)
+{
+    return screen_text_clipped(s, row, col, text, s->cols);
+}
+
+// Same, but nothing is placed past column `last_col`
+int screen_text_clipped(struct screen *s, int row, int col, const char *text, int last_col)
+{
+    if (row < 1 || row > s->rows)
+    {
+        return 0;
+    }
+    if (last_col > s->cols)
+    {
+        last_col = s->cols;
+    }
+
+    int start = col;
+    struct screen_cell *previous = NULL;
+    while (*text)
+    {
+        unsigned long cp;
+        int length = utf8_decode(text, &cp);
+        int width = codepoint_width(cp);
+
+        if (width == 0)
+        {
+            // Combining mark: attach to the glyph before it
+            if (previous && strlen(previous->glyph) + length < SCREEN_GLYPH_SIZE)
+            {
+                strncat(previous->glyph, text, length);
+            }
+        }
+        else if (col >= 1 && col + width - 1 <= last_col)
+        {
+            // Never leave half of a wide glyph behind
+            for (int c = col; c < col + width; c++)
+            {
+                struct screen_cell *cell = cell_at(s->back, s, row, c);
+                if (cell->width == 0 && c > 1)
+                {
+                    *cell_at(s->back, s, row, c - 1) = blank_cell;
+                }
+                else if (cell->width == 2 && c < s->cols)
+                {
+                    *cell_at(s->back, s, row, c + 1) = blank_cell;
+                }
+            }
+
+            // Including the neighbours a wide glyph may have blanked
+            mark_dirty(s, row, col - 1, col + width);
+            previous = cell_at(s->back, s, row, col);
+            memcpy(previous->glyph, text, length);
+            previous->glyph[length] = '\0';
+            previous->width = width;
+            if (width == 2)
+            {
+                struct screen_cell *continuation = cell_at(s->back, s, row, col + 1);
+                continuation->glyph[0] = '\0';
+                continuation->width = 0;
+            }
+            col += width;
+        }
+        else
+        {
+            previous = NULL;
+            col += width;
+        }
+        text += length;
+    }
+    return col - start;
+}
+
+// Columns `text` would cover
+int screen_text_width(const char *text)
+{
+    int width = 0;
+    while (*text)
+    {
+        unsigned long cp;
+        text += utf8_decode(text, &cp);
+        width += codepoint_width(cp);
+    }
+    return width;
+}
+
+// Leave a visible cursor at a 1-based position after each flush, e.g. in
+// an input field; row 0 hides it
+void screen_cursor(struct screen *s, int row, int col)
+{
+    s->cursor_row = row;
+    s->cursor_col = col;
+}
+
+int screen_printf(struct screen *s, int row, int col, const char *format, ...)
+{
+    char text[SCREEN_TEXT_MAX];
+    va_list args;
+
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    return screen_text(s, row, col, text);
+}
+
+// Repeat one glyph `count` times, e.g. borders and progress bars
+void screen_fill(struct screen *s, int row, int col, int count, const char *glyph)
+{
+    for (int i = 0; i < count; i++)
+    {
+        col += screen_text(s, row, col, glyph);
+    }
+}
+
+static int cell_equal(const struct screen_cell *a, const struct screen_cell *b)
+{
+    return a->width == b->width && strcmp(a->glyph, b->glyph) == 0;
+}
+
+static char *emit(char *p, const char *bytes, size_t length)
+{
+    memcpy(p, bytes, length);
+    return p + length;
+}
+
+// Send the changed cells and make the composed frame current. A
+// non-blocking `fd` is waited on until it takes the whole frame. Returns
+// the bytes written, or -1 on a write error, after which the next flush
+// repaints everything.
+ssize_t screen_flush(struct screen *s, int fd)
+{
+    char *p = s->out;
+    int cursor_row = 0, cursor_col = 0; // Unknown
+
+    int everything = s->clear_pending;
+    if (s->clear_pending)
+    {
+        // A cleared terminal shows blanks, so only the rest needs sending
+        p = emit(p, SCREEN_CLEAR, sizeof(SCREEN_CLEAR) - 1);
+        fill_blank(s->front, s->rows * s->cols);
+        s->clear_pending = 0;
+    }
+
+    for (int row = 1; row <= s->rows; row++)
+    {
+        struct screen_cell *front = cell_at(s->front, s, row, 1);
+        struct screen_cell *back = cell_at(s->back, s, row, 1);
+        int col = everything ? 1 : s->dirty_first[row - 1];
+        int last = everything ? s->cols : s->dirty_last[row - 1];
+        s->dirty_first[row - 1] = s->cols + 1;
+        s->dirty_last[row - 1] = 0;
+
+        while (col <= last)
+        {
+            if (cell_equal(&front[col - 1], &back[col - 1]))
+            {
+                col++;
+                continue;
+            }
+
+            // Start the run on the leading cell of a wide glyph
+            while (col > 1 && back[col - 1].width == 0)
+            {
+                col--;
+            }
+
+            // Extend while cells differ or the unchanged gap is shorter than a jump
+            int end = col;
+            int gap = 0;
+            for (int c = col; c <= last; c++)
+            {
+                if (!cell_equal(&front[c - 1], &back[c - 1]))
+                {
+                    end = c;
+                    gap = 0;
+                }
+                else if (++gap > SCREEN_MAX_GAP)
+                {
+                    break;
+                }
+            }
+
+            if (cursor_row != row || cursor_col != col)
+            {
+                p += sprintf(p, "\033[%d;%dH", row, col);
+            }
+            for (int c = col; c <= end; c++)
+            {
+                const struct screen_cell *cell = &back[c - 1];
+                if (cell->width > 0)
+                {
+                    p = emit(p, cell->glyph, strlen(cell->glyph));
+                }
+                front[c - 1] = *cell;
+            }
+            col = end + 1;
+
+            // Past the last column the terminal's cursor position is pending-wrap
+            cursor_row = row;
+            cursor_col = col <= s->cols ? col : 0;
+        }
+    }
+
+    // The cursor goes back to the input field after the cells are drawn
+    if (s->cursor_row > 0)
+    {
+        if (p != s->out || s->cursor_shown != 1 || s->shown_row != s->cursor_row || s->shown_col != s->cursor_col)
+        {
+            p += sprintf(p, "\033[%d;%dH", s->cursor_row, s->cursor_col);
+            if (s->cursor_shown != 1)
+            {
+                p = emit(p, SCREEN_SHOW_CURSOR, sizeof(SCREEN_SHOW_CURSOR) - 1);
+            }
+            s->cursor_shown = 1;
+            s->shown_row = s->cursor_row;
+            s->shown_col = s->cursor_col;
+        }
+    }
+    else if (s->cursor_shown != 0)
+    {
+        p = emit(p, SCREEN_HIDE_CURSOR, sizeof(SCREEN_HIDE_CURSOR) - 1);
+        s->cursor_shown = 0;
+    }
+
+    size_t length = p - s->out;
+    size_t sent = 0;
+    while (sent < length)
+    {
+        ssize_t n = write(fd, s->out + sent, length - sent);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            struct pollfd pfd = {.fd = fd, .events = POLLOUT};
+            if ((errno == EAGAIN || errno == EWOULDBLOCK) && (poll(&pfd, 1, -1) >= 0 || errno == EINTR))
+            {
+                continue;
+            }
+            // `front` already holds this frame, which never fully arrived
+            screen_invalidate(s);
+            return -1;
+        }
+        sent += n;
+        s->writes++;
+    }
+    s->bytes_written += sent;
+    return sent;
+}
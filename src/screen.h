@@ -0,0 +1,61 @@
+#ifndef SCREEN_H
+#define SCREEN_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+// Constants
+#define SCREEN_GLYPH_SIZE 8   // One UTF-8 character plus combining marks
+#define SCREEN_MAX_GAP 4      // Unchanged cells rewritten rather than jumped over
+#define SCREEN_MAX_ROWS 512
+#define SCREEN_MAX_COLS 1024
+
+// Struct definitions
+// A wide glyph occupies its cell plus a continuation cell of width 0
+struct screen_cell
+{
+    char glyph[SCREEN_GLYPH_SIZE];
+    unsigned char width;
+};
+
+// Double-buffered cell grid. Frames are composed into `back`, then
+// screen_flush() sends only the cells that differ from `front` (what the
+// terminal is showing) in a single write(). Each row remembers the span
+// written since the last flush, so the comparison costs what was drawn
+// rather than the whole screen.
+struct screen
+{
+    int rows;
+    int cols;
+    struct screen_cell *front;
+    struct screen_cell *back;
+    int *dirty_first;            // Per row, first and last column written;
+    int *dirty_last;             // first > last when nothing was
+    char *out;                   // Preallocated escape sequence buffer
+    size_t out_size;
+    int clear_pending;           // Next flush clears and repaints everything
+    int cursor_row;              // Where to leave a visible cursor, 0 hides it
+    int cursor_col;
+    int cursor_shown;            // What the terminal currently has, -1 unknown
+    int shown_row;
+    int shown_col;
+    unsigned long bytes_written; // Totals for benchmarking
+    unsigned long writes;
+};
+
+// Function declarations
+int screen_init(struct screen *s, int rows, int cols);
+int screen_resize(struct screen *s, int rows, int cols);
+void screen_free(struct screen *s);
+void screen_invalidate(struct screen *s);
+void screen_clear(struct screen *s);
+int screen_text(struct screen *s, int row, int col, const char *text);
+int screen_text_clipped(struct screen *s, int row, int col, const char *text, int last_col);
+int screen_printf(struct screen *s, int row, int col, const char *format, ...)
+    __attribute__((format(printf, 4, 5)));
+int screen_text_width(const char *text);
+void screen_cursor(struct screen *s, int row, int col);
+void screen_fill(struct screen *s, int row, int col, int count, const char *glyph);
+ssize_t screen_flush(struct screen *s, int fd);
+
+#endif /* SCREEN_H */
@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "control.h"
+#include "countdown.h"
+#include "hal.h"
+#include "hal_sim.h"
+
+// Runs the real controller against the simulated drier on a virtual clock.
+// Usage: drier-sim [--pid] [--output=MODE] [TEMP:SECONDS ...]   e.g. drier-sim 70:43200 45:86400
+
+#define MAX_PROFILE_STEPS 32
+
+// Struct definitions
+struct profile_step
+{
+    float temp;
+    int duration;
+};
+
+static struct drier drier;
+
+// Default profile: nylon for 12 hours, then PLA for a day, then PETG
+static const struct profile_step default_profile[] = {
+    {70.0, 43200},
+    {45.0, 86400},
+    {65.0, 43200},
+};
+
+static double wall_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int parse_profile(int argc, char **argv, struct profile_step *steps)
+{
+    int count = 0;
+    for (int i = 1; i < argc && count < MAX_PROFILE_STEPS; i++)
+    {
+        if (argv[i][0] == '-')
+        {
+            continue;
+        }
+        if (sscanf(argv[i], "%f:%d", &steps[count].temp, &steps[count].duration) != 2 ||
+            steps[count].duration <= 0)
+        {
+            fprintf(stderr, "Invalid profile step '%s', expected TEMP:SECONDS\n", argv[i]);
+            return -1;
+        }
+        count++;
+    }
+    return count;
+}
+
+// One control cycle at the SAMPLE_INTERVAL cadence
+static float run_step(void)
+{
+    double tick_start = hal_time();
+
+    float current_temp = read_temperature(&drier);
+    // Step transitions are setpoint reverts on the timer wheel
+    control_run_timers(&drier);
+    control_heater(&drier, current_temp);
+
+    // Sleep to the next deadline; on the virtual clock this returns at once
+    heater_sleep_until(&drier, tick_start + SAMPLE_INTERVAL / 1000.0);
+    return current_temp;
+}
+
+int main(int argc, char **argv)
+{
+    struct profile_step steps[MAX_PROFILE_STEPS];
+    int step_count = parse_profile(argc, argv, steps);
+    if (step_count < 0)
+    {
+        return 1;
+    }
+    if (step_count == 0)
+    {
+        step_count = sizeof(default_profile) / sizeof(default_profile[0]);
+        for (int i = 0; i < step_count; i++)
+        {
+            steps[i] = default_profile[i];
+        }
+    }
+
+    hal_init();
+    hal_sim_use_virtual_clock(0.0);
+    int output_mode = OUTPUT_SWITCHED;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--output=", 9) == 0 && (output_mode = output_parse_mode(argv[i] + 9)) < 0)
+        {
+            fprintf(stderr, "Unknown output mode '%s'\n", argv[i] + 9);
+            return 1;
+        }
+    }
+    control_init(&drier, output_mode);
+    drier.pid_gains_path = NULL; // Gains tuned on the simulated plant must never reach a real drier
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--pid") == 0)
+        {
+            control_use_pid(&drier);
+        }
+    }
+
+    int total_seconds = 0;
+    for (int i = 0; i < step_count; i++)
+    {
+        total_seconds += steps[i].duration;
+    }
+
+    // The whole run is one more deadline on the same wheel
+    struct timer drying_timer;
+    int64_t now = control_clock_ns();
+    timer_init(&drying_timer, NULL, NULL);
+    timer_arm(&drier.timers, &drying_timer, now, now + (int64_t)total_seconds * NS_PER_SECOND);
+
+    double wall_start = wall_seconds();
+    long ticks = 0;
+
+    for (int i = 0; i < step_count; i++)
+    {
+        set_temporary_temp(&drier, steps[i].temp, steps[i].duration);
+
+        double step_start = hal_time();
+        double reached_at = -1;
+        float min_temp = MAX_TEMP, max_temp = 0;
+        double sum_temp = 0;
+        long samples = 0;
+
+        // The setpoint expiry ends the step, exactly as it would on the Pi
+        while (drier.temp_change_duration > 0)
+        {
+            float current_temp = run_step();
+            ticks++;
+            if (current_temp < 0)
+            {
+                continue;
+            }
+            if (reached_at < 0 && current_temp >= steps[i].temp - TEMP_TOLERANCE &&
+                current_temp <= steps[i].temp + TEMP_TOLERANCE)
+            {
+                reached_at = hal_time() - step_start;
+            }
+            if (reached_at >= 0)
+            {
+                min_temp = current_temp < min_temp ? current_temp : min_temp;
+                max_temp = current_temp > max_temp ? current_temp : max_temp;
+                sum_temp += current_temp;
+                samples++;
+            }
+        }
+
+        printf("Step %d: %.1f°C for %d s: ", i + 1, steps[i].temp, steps[i].duration);
+        if (samples > 0)
+        {
+            printf("settled in %.0f s, min %.1f°C, mean %.1f°C, max %.1f°C\n",
+                   reached_at, min_temp, sum_temp / samples, max_temp);
+        }
+        else
+        {
+            printf("setpoint never reached\n");
+        }
+    }
+
+    double wall_elapsed = wall_seconds() - wall_start;
+    double simulated = hal_time();
+
+    struct time remaining;
+    countdown_set(&remaining, timer_remaining_ns(&drying_timer, control_clock_ns()) / NS_PER_SECOND);
+    printf("Timer remaining: %dd %02d:%02d:%02d\n",
+           remaining.days, remaining.hours, remaining.minutes, remaining.seconds);
+    printf("Simulated %.0f s (%ld control cycles) in %.3f s wall time: %.0f simulated s per wall s\n",
+           simulated, ticks, wall_elapsed, simulated / (wall_elapsed > 0 ? wall_elapsed : 1e-9));
+
+    hal_terminate();
+    return 0;
+}
@@ -0,0 +1,275 @@
+#include <math.h>
+#include <string.h>
+#include "sparkline.h"
+
+static const struct sparkline_column empty_column = {0, 0, 0, 0};
+
+static int clamp(int value, int low, int high)
+{
+    return value < low ? low : value > high ? high : value;
+}
+
+// Fold `c` into `into`; gaps only carry the setpoint along
+static void merge_column(struct sparkline_column *into, const struct sparkline_column *c)
+{
+    if (c->samples > 0)
+    {
+        into->min = into->samples == 0 || c->min < into->min ? c->min : into->min;
+        into->max = into->samples == 0 || c->max > into->max ? c->max : into->max;
+        into->samples += c->samples;
+    }
+    into->setpoint = c->setpoint;
+}
+
+static void push_column(struct sparkline *s, const struct sparkline_column *c)
+{
+    s->columns[s->head] = *c;
+    s->head = (s->head + 1) % SPARKLINE_MAX_COLS;
+    s->sweep = (s->sweep + 1) % s->width;
+    if (s->count < s->width - 1)
+    {
+        s->count++;
+    }
+}
+
+// Plot position of the column `age` intervals before the open one
+static int position_of(const struct sparkline *s, int age)
+{
+    return ((s->sweep - age) % s->width + s->width) % s->width;
+}
+
+// Column shown at plot position `x`, or NULL for the gap ahead of the
+// sweep and before the history reaches back that far
+static const struct sparkline_column *column_at(const struct sparkline *s, int x)
+{
+    int age = (s->sweep - x + s->width) % s->width;
+    if (age == 0)
+    {
+        return &s->open;
+    }
+    if (age > s->count || age == s->width - 1)
+    {
+        return NULL;
+    }
+    return &s->columns[(s->head - age + SPARKLINE_MAX_COLS) % SPARKLINE_MAX_COLS];
+}
+
+void sparkline_init(struct sparkline *s, int64_t span_ns, int width, int64_t now_ns)
+{
+    memset(s, 0, sizeof(*s));
+    s->span_ns = span_ns;
+    s->width = clamp(width, 1, SPARKLINE_MAX_COLS);
+    s->column_ns = span_ns / s->width > 0 ? span_ns / s->width : 1;
+    s->open_start_ns = now_ns;
+}
+
+// Change the number of columns, keeping the span: the closed columns are
+// resampled to the new interval. Only on a terminal resize; the caller
+// draws again afterwards.
+void sparkline_resize(struct sparkline *s, int width)
+{
+    static struct sparkline_column old[SPARKLINE_MAX_COLS];
+
+    width = clamp(width, 1, SPARKLINE_MAX_COLS);
+    if (width == s->width)
+    {
+        return;
+    }
+
+    int old_count = s->count;
+    for (int i = 0; i < old_count; i++)
+    {
+        old[i] = s->columns[(s->head - old_count + i + SPARKLINE_MAX_COLS) % SPARKLINE_MAX_COLS];
+    }
+
+    int64_t column_ns = s->span_ns / width > 0 ? s->span_ns / width : 1;
+    int count = (int)((int64_t)old_count * s->column_ns / column_ns);
+    if (count < 1 && old_count > 0)
+    {
+        count = 1;
+    }
+    if (count > width - 1)
+    {
+        count = width - 1;
+    }
+    for (int j = 0; j < count; j++)
+    {
+        int from = j * old_count / count;
+        int to = (j + 1) * old_count / count;
+        s->columns[j] = empty_column;
+        for (int i = from; i < (to > from ? to : from + 1); i++)
+        {
+            merge_column(&s->columns[j], &old[i]);
+        }
+    }
+
+    s->width = width;
+    s->column_ns = column_ns;
+    s->count = count;
+    s->head = count % SPARKLINE_MAX_COLS;
+    s->sweep = count % width;
+}
+
+// Add a sample taken at `now_ns`; a negative temperature is a failed read
+// and leaves a gap. Returns how many columns closed since the last call,
+// at most the width.
+int sparkline_add(struct sparkline *s, int64_t now_ns, float temperature, float setpoint)
+{
+    int closed = 0;
+    int64_t elapsed = (now_ns - s->open_start_ns) / s->column_ns;
+    if (elapsed > 0)
+    {
+        // Columns nothing was sampled in, e.g. while suspended, stay empty
+        closed = elapsed < s->width ? (int)elapsed : s->width;
+        push_column(s, &s->open);
+        for (int i = 1; i < closed; i++)
+        {
+            struct sparkline_column gap = {0, 0, s->open.setpoint, 0};
+            push_column(s, &gap);
+        }
+        s->open_start_ns += elapsed * s->column_ns;
+        s->open = empty_column;
+    }
+
+    struct sparkline_column sample = {temperature, temperature, setpoint, temperature >= 0};
+    merge_column(&s->open, &sample);
+    return closed;
+}
+
+// Half-row step `value` falls in, counted from the bottom
+static int half_row(const struct sparkline *s, float value)
+{
+    int steps = s->height * 2;
+    return clamp((int)((value - s->low) / (s->high - s->low) * steps), 0, steps - 1);
+}
+
+static int setpoint_shown(const struct sparkline *s, const struct sparkline_column *c)
+{
+    return c && c->setpoint > 0 && c->setpoint >= s->low && c->setpoint <= s->high;
+}
+
+// Each cell is two half-rows, so the min..max range of a column is drawn
+// in full and half blocks; the setpoint shows where the range leaves room
+static void draw_column(const struct sparkline *s, struct screen *screen, int x)
+{
+    const struct sparkline_column *c = column_at(s, x);
+    int bottom = c && c->samples > 0 ? half_row(s, c->min) : 1;
+    int top = c && c->samples > 0 ? half_row(s, c->max) : 0;
+    int setpoint = setpoint_shown(s, c) ? half_row(s, c->setpoint) / 2 : -1;
+    int col = s->col + SPARKLINE_AXIS_WIDTH + x;
+
+    for (int cell = 0; cell < s->height; cell++)
+    {
+        int lower = bottom <= 2 * cell && 2 * cell <= top;
+        int upper = bottom <= 2 * cell + 1 && 2 * cell + 1 <= top;
+        const char *glyph = lower && upper ? "█" : lower ? "▄" : upper ? "▀" : cell == setpoint ? "─" : " ";
+        screen_text(screen, s->row + s->height - 1 - cell, col, glyph);
+    }
+}
+
+static int column_fits(const struct sparkline *s, const struct sparkline_column *c)
+{
+    return (c->samples == 0 || (c->min >= s->low && c->max <= s->high)) &&
+           (c->setpoint <= 0 || setpoint_shown(s, c));
+}
+
+// Round the scale out to whole steps around everything on the plot, at
+// least two steps tall. Returns whether it changed.
+static int fit_scale(struct sparkline *s)
+{
+    float low = INFINITY, high = -INFINITY;
+    for (int x = 0; x < s->width; x++)
+    {
+        const struct sparkline_column *c = column_at(s, x);
+        if (c && c->samples > 0)
+        {
+            low = fminf(low, c->min);
+            high = fmaxf(high, c->max);
+        }
+        if (c && c->setpoint > 0)
+        {
+            low = fminf(low, c->setpoint);
+            high = fmaxf(high, c->setpoint);
+        }
+    }
+    if (low > high)
+    {
+        low = high = 20; // Nothing yet: room temperature
+    }
+
+    low = floorf(low / SPARKLINE_SCALE_STEP) * SPARKLINE_SCALE_STEP;
+    high = ceilf(high / SPARKLINE_SCALE_STEP) * SPARKLINE_SCALE_STEP;
+    if (high - low < 2 * SPARKLINE_SCALE_STEP)
+    {
+        high = low + 2 * SPARKLINE_SCALE_STEP;
+    }
+
+    s->since_fit = 0;
+    if (low == s->low && high == s->high)
+    {
+        return 0;
+    }
+    s->low = low;
+    s->high = high;
+    return 1;
+}
+
+// Draw the whole chart with its scale labels, `height` rows from `row`,
+// the labels starting at `col`. Needed after a resize or a full repaint;
+// afterwards sparkline_update() keeps it current.
+void sparkline_draw(struct sparkline *s, struct screen *screen, int row, int col, int height)
+{
+    s->row = row;
+    s->col = col;
+    s->height = height > 0 ? height : 0;
+    if (s->height == 0)
+    {
+        return;
+    }
+
+    fit_scale(s);
+    for (int r = row; r < row + s->height; r++)
+    {
+        screen_fill(screen, r, col, SPARKLINE_AXIS_WIDTH, " ");
+    }
+    screen_printf(screen, row, col, "%5.0f°C", s->high);
+    screen_printf(screen, row + s->height - 1, col, "%5.0f°C", s->low);
+    for (int x = 0; x < s->width; x++)
+    {
+        draw_column(s, screen, x);
+    }
+}
+
+// After sparkline_add() returned `closed`: draw the open column, the
+// ones that closed behind it and the gap that moved ahead of it. The
+// scale grows as soon as a value falls outside it and is refitted once
+// per full sweep, so the whole plot is only redrawn when it changes.
+void sparkline_update(struct sparkline *s, struct screen *screen, int closed)
+{
+    if (s->height == 0)
+    {
+        return;
+    }
+
+    s->since_fit += closed;
+    int stale = closed >= s->width || s->since_fit >= s->width;
+    for (int age = 0; age <= closed && !stale; age++)
+    {
+        const struct sparkline_column *c = column_at(s, position_of(s, age));
+        stale = c && !column_fits(s, c);
+    }
+    if (stale && fit_scale(s))
+    {
+        sparkline_draw(s, screen, s->row, s->col, s->height);
+        return;
+    }
+
+    for (int age = 0; age <= closed && age < s->width; age++)
+    {
+        draw_column(s, screen, position_of(s, age));
+    }
+    if (closed > 0 && closed < s->width - 1)
+    {
+        draw_column(s, screen, position_of(s, -1));
+    }
+}
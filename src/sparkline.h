@@ -0,0 +1,56 @@
+#ifndef SPARKLINE_H
+#define SPARKLINE_H
+
+#include <stdint.h>
+#include "screen.h"
+
+// Constants
+#define SPARKLINE_MAX_COLS SCREEN_MAX_COLS
+#define SPARKLINE_AXIS_WIDTH 8   // Scale labels left of the plot, e.g. " 70.0°C "
+#define SPARKLINE_SCALE_STEP 5.0 // °C the vertical scale is rounded to
+
+// Struct definitions
+// Min/max downsampling of every sample that fell in one column's interval
+struct sparkline_column
+{
+    float min;
+    float max;
+    float setpoint;  // Latest in the interval
+    int samples;     // Zero for a gap, e.g. a failed sensor
+};
+
+// Sweeping temperature chart covering the last `span_ns`, one column per
+// span / width. Samples fold into the open column; when its interval ends
+// it stays where it is and the next column opens to its right, wrapping
+// at the edge, with a blank column ahead of it marking the sweep. Nothing
+// on the plot moves, so per sample the cost is a few columns' worth of
+// cells whatever the width or span.
+struct sparkline
+{
+    int64_t span_ns;
+    int64_t column_ns;
+    int width;                     // Plot columns, the open one included
+    int head;                      // Ring slot the next closed column goes to
+    int count;                     // Closed columns held, at most width - 1
+    int sweep;                     // Plot column of the open one
+    int64_t open_start_ns;
+    struct sparkline_column open;
+    struct sparkline_column columns[SPARKLINE_MAX_COLS];
+
+    // Where it was last drawn; height 0 until then
+    int row;
+    int col;
+    int height;
+    float low;                     // Vertical scale
+    float high;
+    int since_fit;                 // Columns scrolled since the scale was fitted
+};
+
+// Function declarations
+void sparkline_init(struct sparkline *s, int64_t span_ns, int width, int64_t now_ns);
+void sparkline_resize(struct sparkline *s, int width);
+int sparkline_add(struct sparkline *s, int64_t now_ns, float temperature, float setpoint);
+void sparkline_draw(struct sparkline *s, struct screen *screen, int row, int col, int height);
+void sparkline_update(struct sparkline *s, struct screen *screen, int closed);
+
+#endif /* SPARKLINE_H */
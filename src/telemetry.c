@@ -0,0 +1,314 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "log.h"
+#include "telemetry.h"
+
+static const uint32_t tier_widths[TELEMETRY_TIERS] = TELEMETRY_TIER_WIDTHS_MS;
+static const uint32_t tier_capacities[TELEMETRY_TIERS] = TELEMETRY_TIER_CAPACITIES;
+
+static uint64_t page_align(uint64_t offset)
+{
+    uint64_t page = sysconf(_SC_PAGESIZE);
+    return (offset + page - 1) / page * page;
+}
+
+// Header in its own page, then each ring starting on a page boundary, so
+// a sample dirties the header page, one raw page and at most one page per
+// tier that closes a bucket
+static size_t build_layout(struct telemetry_header *header)
+{
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, TELEMETRY_MAGIC, sizeof(header->magic));
+    header->version = TELEMETRY_VERSION;
+    header->tiers = TELEMETRY_TIERS;
+
+    uint64_t offset = page_align(sizeof(*header));
+    header->raw = (struct telemetry_ring){0, offset, TELEMETRY_RAW_CAPACITY, 0};
+    offset = page_align(offset + (uint64_t)TELEMETRY_RAW_CAPACITY * sizeof(struct telemetry_sample));
+    for (int i = 0; i < TELEMETRY_TIERS; i++)
+    {
+        header->tier[i] = (struct telemetry_ring){0, offset, tier_capacities[i], tier_widths[i]};
+        offset = page_align(offset + (uint64_t)tier_capacities[i] * sizeof(struct telemetry_bucket));
+    }
+    return offset;
+}
+
+static int same_layout(const struct telemetry_header *a, const struct telemetry_header *b)
+{
+    if (memcmp(a->magic, b->magic, sizeof(a->magic)) != 0 || a->version != b->version || a->tiers != b->tiers ||
+        a->raw.offset != b->raw.offset || a->raw.capacity != b->raw.capacity)
+    {
+        return 0;
+    }
+    for (int i = 0; i < TELEMETRY_TIERS; i++)
+    {
+        if (a->tier[i].offset != b->tier[i].offset || a->tier[i].capacity != b->tier[i].capacity ||
+            a->tier[i].width_ms != b->tier[i].width_ms)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Open or create the ring file at `path`. An existing file with the same
+// layout keeps its history; anything else is reinitialised. The file is
+// allocated in full up front so appends never extend it.
+int telemetry_open(struct telemetry *t, const char *path)
+{
+    struct telemetry_header layout;
+    size_t size = build_layout(&layout);
+
+    t->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (t->fd < 0)
+    {
+        log_error("Cannot open telemetry file %s: %s", path, strerror(errno));
+        return -1;
+    }
+    struct stat st;
+    if (fstat(t->fd, &st) < 0)
+    {
+        log_error("Cannot stat telemetry file %s: %s", path, strerror(errno));
+        close(t->fd);
+        return -1;
+    }
+    int fresh = (size_t)st.st_size != size;
+    if (fresh && (ftruncate(t->fd, size) < 0 || posix_fallocate(t->fd, 0, size) != 0))
+    {
+        log_error("Cannot allocate %zu bytes for telemetry file %s", size, path);
+        close(t->fd);
+        return -1;
+    }
+
+    // Populated so the control loop never takes a major fault appending
+    t->map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, t->fd, 0);
+    if (t->map == MAP_FAILED)
+    {
+        log_error("Cannot map telemetry file %s", path);
+        close(t->fd);
+        return -1;
+    }
+    t->size = size;
+    t->header = (struct telemetry_header *)t->map;
+
+    if (!fresh && !same_layout(t->header, &layout))
+    {
+        log_warn("Telemetry file %s has a different layout, starting a new history", path);
+        fresh = 1;
+    }
+    if (fresh)
+    {
+        *t->header = layout;
+    }
+    return 0;
+}
+
+void telemetry_close(struct telemetry *t)
+{
+    msync(t->map, t->size, MS_SYNC);
+    munmap(t->map, t->size);
+    close(t->fd);
+}
+
+static struct telemetry_sample *raw_record(const struct telemetry *t, uint64_t index)
+{
+    const struct telemetry_ring *ring = &t->header->raw;
+    return (struct telemetry_sample *)(t->map + ring->offset) + index % ring->capacity;
+}
+
+static struct telemetry_bucket *tier_record(const struct telemetry *t, int tier, uint64_t index)
+{
+    const struct telemetry_ring *ring = &t->header->tier[tier];
+    return (struct telemetry_bucket *)(t->map + ring->offset) + index % ring->capacity;
+}
+
+static void pending_reset(struct telemetry_pending *p, int64_t start_ms)
+{
+    memset(p, 0, sizeof(*p));
+    p->start_ms = start_ms;
+}
+
+static void pending_add(struct telemetry_pending *p, const struct telemetry_bucket *b)
+{
+    if (b->valid > 0)
+    {
+        if (p->valid == 0 || b->min_temperature < p->min_temperature)
+        {
+            p->min_temperature = b->min_temperature;
+        }
+        if (p->valid == 0 || b->max_temperature > p->max_temperature)
+        {
+            p->max_temperature = b->max_temperature;
+        }
+        p->temperature_sum += (double)b->mean_temperature * b->valid;
+        p->valid += b->valid;
+    }
+    p->setpoint_sum += (double)b->mean_setpoint * b->samples;
+    p->duty_sum += (double)b->mean_duty * b->samples;
+    p->samples += b->samples;
+    p->flags |= b->flags;
+}
+
+// Bucket summarising what `p` has accumulated; no valid temperature reads
+// -1, like a failed sensor read
+static struct telemetry_bucket pending_finish(const struct telemetry_pending *p)
+{
+    struct telemetry_bucket b = {.start_ms = p->start_ms, .samples = p->samples, .valid = p->valid, .flags = p->flags};
+    b.min_temperature = p->valid ? p->min_temperature : -1;
+    b.max_temperature = p->valid ? p->max_temperature : -1;
+    b.mean_temperature = p->valid ? p->temperature_sum / p->valid : -1;
+    b.mean_setpoint = p->samples ? p->setpoint_sum / p->samples : 0;
+    b.mean_duty = p->samples ? p->duty_sum / p->samples : 0;
+    return b;
+}
+
+static struct telemetry_bucket sample_bucket(const struct telemetry_sample *s)
+{
+    return (struct telemetry_bucket){
+        .start_ms = s->time_ms,
+        .min_temperature = s->temperature,
+        .max_temperature = s->temperature,
+        .mean_temperature = s->temperature,
+        .mean_setpoint = s->setpoint,
+        .mean_duty = s->duty,
+        .samples = 1,
+        .valid = !(s->flags & TELEMETRY_SENSOR_FAULT),
+        .flags = s->flags,
+    };
+}
+
+// Store one sample and fold it into every tier's open bucket, closing
+// buckets whose interval has ended. Only stores into the mapping: the
+// kernel writes the few dirtied pages back on its own schedule, which
+// coalesces a tick's writes and keeps the control loop off the SD card.
+void telemetry_append(struct telemetry *t, const struct telemetry_sample *sample)
+{
+    struct telemetry_header *h = t->header;
+    struct telemetry_sample s = *sample;
+
+    // Rings are searched by time, so a clock stepped backwards is held
+    // at the newest time already stored
+    if (h->raw.written > 0 && s.time_ms < raw_record(t, h->raw.written - 1)->time_ms)
+    {
+        s.time_ms = raw_record(t, h->raw.written - 1)->time_ms;
+    }
+    *raw_record(t, h->raw.written) = s;
+    h->raw.written++;
+
+    struct telemetry_bucket b = sample_bucket(&s);
+    for (int i = 0; i < TELEMETRY_TIERS; i++)
+    {
+        struct telemetry_pending *p = &h->pending[i];
+        int64_t start = s.time_ms - s.time_ms % h->tier[i].width_ms;
+        if (p->samples > 0 && start != p->start_ms)
+        {
+            *tier_record(t, i, h->tier[i].written) = pending_finish(p);
+            h->tier[i].written++;
+        }
+        if (p->samples == 0 || start != p->start_ms)
+        {
+            pending_reset(p, start);
+        }
+        pending_add(p, &b);
+    }
+}
+
+static int64_t record_time(const struct telemetry *t, int tier, uint64_t index)
+{
+    return tier < 0 ? raw_record(t, index)->time_ms : tier_record(t, tier, index)->start_ms;
+}
+
+static struct telemetry_bucket record_bucket(const struct telemetry *t, int tier, uint64_t index)
+{
+    return tier < 0 ? sample_bucket(raw_record(t, index)) : *tier_record(t, tier, index);
+}
+
+// First index in [lo, hi) whose time is >= `time`, by binary search
+static uint64_t lower_bound(const struct telemetry *t, int tier, uint64_t lo, uint64_t hi, int64_t time)
+{
+    while (lo < hi)
+    {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (record_time(t, tier, mid) < time)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Records of `tier` (-1 for raw) in [from_ms, to_ms]: sets *first and
+// returns how many. Sets *covered if the ring reaches back to from_ms.
+static uint64_t ring_range(const struct telemetry *t, int tier, int64_t from_ms, int64_t to_ms, uint64_t *first,
+                           int *covered)
+{
+    const struct telemetry_ring *ring = tier < 0 ? &t->header->raw : &t->header->tier[tier];
+    uint64_t oldest = ring->written > ring->capacity ? ring->written - ring->capacity : 0;
+    *covered = oldest == 0 || (ring->written > oldest && record_time(t, tier, oldest) <= from_ms);
+    *first = lower_bound(t, tier, oldest, ring->written, from_ms);
+    return lower_bound(t, tier, *first, ring->written, to_ms + 1) - *first;
+}
+
+// At most `max_points` buckets covering [from_ms, to_ms], oldest first,
+// from the finest resolution that both reaches back far enough and fits;
+// otherwise the coarsest, merged down to size. Binary searches locate the
+// range, so the cost depends on the points returned, not on the history.
+// Returns the number of buckets written to `out`.
+int telemetry_query(const struct telemetry *t, int64_t from_ms, int64_t to_ms, int max_points,
+                    struct telemetry_bucket *out)
+{
+    if (max_points <= 0 || to_ms < from_ms)
+    {
+        return 0;
+    }
+
+    // Falls through to the coarsest tier, whose range the last pass leaves
+    int tier = TELEMETRY_TIERS - 1;
+    uint64_t first = 0, count = 0;
+    int covered;
+    for (int i = -1; i < TELEMETRY_TIERS; i++)
+    {
+        count = ring_range(t, i, from_ms, to_ms, &first, &covered);
+        if (covered && count <= (uint64_t)max_points)
+        {
+            tier = i;
+            break;
+        }
+    }
+
+    // The open bucket of a tier is the newest data it has
+    const struct telemetry_pending *open = tier >= 0 ? &t->header->pending[tier] : NULL;
+    int with_open = open && open->samples > 0 && open->start_ms >= from_ms && open->start_ms <= to_ms;
+    uint64_t total = count + with_open;
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    // Merge consecutive records when even the coarsest tier has too many
+    uint64_t group = (total + max_points - 1) / max_points;
+    int points = 0;
+    struct telemetry_pending merged;
+    for (uint64_t i = 0; i < total; i++)
+    {
+        struct telemetry_bucket b = i < count ? record_bucket(t, tier, first + i) : pending_finish(open);
+        if (i % group == 0)
+        {
+            pending_reset(&merged, b.start_ms);
+        }
+        pending_add(&merged, &b);
+        if (i % group == group - 1 || i == total - 1)
+        {
+            out[points++] = pending_finish(&merged);
+        }
+    }
+    return points;
+}
@@ -0,0 +1,99 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// History of the drier in one memory-mapped file: a ring of raw samples
+// plus rings of 10 s, 1 min and 10 min min/max/mean buckets, each kept up
+// to date as samples arrive. About 4 MB holds half a day of raw samples
+// and six months of 10 min buckets.
+
+// Constants
+#define TELEMETRY_MAGIC "DRIERTS1"
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_TIERS 3
+#define TELEMETRY_RAW_CAPACITY 8640    // 12 h at one sample per 5 s tick
+#define TELEMETRY_TIER_WIDTHS_MS {10000, 60000, 600000}
+#define TELEMETRY_TIER_CAPACITIES {25920, 44640, 26352} // 3 days, 31 days, 183 days
+
+// Sample flags
+#define TELEMETRY_HEATING 1      // Heater output on
+#define TELEMETRY_SENSOR_FAULT 2 // No valid temperature; excluded from min/max/mean
+#define TELEMETRY_SAFETY 4       // Interlock or watchdog holding the heater off
+#define TELEMETRY_TEMPORARY 8    // Temporary setpoint in force
+
+// Struct definitions
+struct telemetry_sample
+{
+    int64_t time_ms; // Wall clock
+    float temperature;
+    float setpoint;
+    float duty;
+    uint32_t flags;
+};
+
+// Summary of every sample whose time falls in [start_ms, start_ms + width)
+struct telemetry_bucket
+{
+    int64_t start_ms;
+    float min_temperature;
+    float max_temperature;
+    float mean_temperature;
+    float mean_setpoint;
+    float mean_duty;
+    uint32_t samples;
+    uint32_t valid;  // Samples with a temperature
+    uint32_t flags;  // Union of the samples' flags
+};
+
+// Layout of one ring inside the file
+struct telemetry_ring
+{
+    uint64_t written;  // Records ever appended; the newest is written - 1
+    uint64_t offset;   // From the start of the file, page aligned
+    uint32_t capacity;
+    uint32_t width_ms; // 0 for the raw ring
+};
+
+// Bucket being filled for each tier, kept in the file so a restart
+// carries on where it stopped
+struct telemetry_pending
+{
+    int64_t start_ms;
+    double temperature_sum;
+    double setpoint_sum;
+    double duty_sum;
+    float min_temperature;
+    float max_temperature;
+    uint32_t samples;
+    uint32_t valid;
+    uint32_t flags;
+};
+
+struct telemetry_header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t tiers;
+    struct telemetry_ring raw;
+    struct telemetry_ring tier[TELEMETRY_TIERS];
+    struct telemetry_pending pending[TELEMETRY_TIERS];
+};
+
+struct telemetry
+{
+    int fd;
+    size_t size;
+    unsigned char *map;
+    struct telemetry_header *header;
+};
+
+// Function declarations
+int telemetry_open(struct telemetry *t, const char *path);
+void telemetry_close(struct telemetry *t);
+void telemetry_append(struct telemetry *t, const struct telemetry_sample *sample);
+int telemetry_query(const struct telemetry *t, int64_t from_ms, int64_t to_ms, int max_points,
+                    struct telemetry_bucket *out);
+
+#endif /* TELEMETRY_H */
@@ -0,0 +1,194 @@
+#include <stddef.h>
+#include "timers.h"
+
+void timer_wheel_init(struct timer_wheel *wheel, int64_t now_ns)
+{
+    for (int i = 0; i < TIMER_WHEEL_SLOTS; i++)
+    {
+        wheel->slots[i] = NULL;
+    }
+    wheel->tick = now_ns / TIMER_TICK_NS - 1;
+    wheel->armed_count = 0;
+    wheel->earliest_ns = -1;
+    wheel->earliest_stale = 0;
+}
+
+void timer_init(struct timer *timer, timer_callback callback, void *arg)
+{
+    timer->start_ns = 0;
+    timer->deadline_ns = 0;
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->armed = 0;
+    timer->next = timer->prev = NULL;
+}
+
+static void unlink_timer(struct timer_wheel *wheel, struct timer *timer)
+{
+    if (timer->prev)
+    {
+        timer->prev->next = timer->next;
+    }
+    else
+    {
+        wheel->slots[(timer->deadline_ns / TIMER_TICK_NS) & TIMER_WHEEL_MASK] = timer->next;
+    }
+    if (timer->next)
+    {
+        timer->next->prev = timer->prev;
+    }
+    timer->next = timer->prev = NULL;
+    timer->armed = 0;
+    wheel->armed_count--;
+
+    if (wheel->armed_count == 0)
+    {
+        wheel->earliest_ns = -1;
+        wheel->earliest_stale = 0;
+    }
+    else if (timer->deadline_ns == wheel->earliest_ns)
+    {
+        wheel->earliest_stale = 1;
+    }
+}
+
+// (Re)arm for an absolute deadline. `start_ns` only matters for progress.
+void timer_arm(struct timer_wheel *wheel, struct timer *timer, int64_t start_ns, int64_t deadline_ns)
+{
+    if (timer->armed)
+    {
+        unlink_timer(wheel, timer);
+    }
+
+    // A deadline in an already processed tick is due at the next expiry
+    if (deadline_ns / TIMER_TICK_NS <= wheel->tick)
+    {
+        deadline_ns = (wheel->tick + 1) * TIMER_TICK_NS;
+    }
+    timer->start_ns = start_ns;
+    timer->deadline_ns = deadline_ns;
+
+    struct timer **slot = &wheel->slots[(deadline_ns / TIMER_TICK_NS) & TIMER_WHEEL_MASK];
+    timer->prev = NULL;
+    timer->next = *slot;
+    if (*slot)
+    {
+        (*slot)->prev = timer;
+    }
+    *slot = timer;
+    timer->armed = 1;
+    wheel->armed_count++;
+
+    if (wheel->armed_count == 1)
+    {
+        wheel->earliest_ns = deadline_ns;
+        wheel->earliest_stale = 0;
+    }
+    else if (!wheel->earliest_stale && deadline_ns < wheel->earliest_ns)
+    {
+        wheel->earliest_ns = deadline_ns;
+    }
+}
+
+void timer_cancel(struct timer_wheel *wheel, struct timer *timer)
+{
+    if (timer->armed)
+    {
+        unlink_timer(wheel, timer);
+    }
+}
+
+// Fire everything in one slot that is due by now_ns. Callbacks may re-arm.
+static int expire_slot(struct timer_wheel *wheel, int64_t tick, int64_t now_ns)
+{
+    int fired = 0;
+    struct timer *timer = wheel->slots[tick & TIMER_WHEEL_MASK];
+    while (timer)
+    {
+        struct timer *next = timer->next;
+        if (timer->deadline_ns <= now_ns)
+        {
+            unlink_timer(wheel, timer);
+            fired++;
+            if (timer->callback)
+            {
+                timer->callback(timer);
+            }
+            // The callback may have unlinked `next`; restart the slot then
+            if (next && !next->armed)
+            {
+                next = wheel->slots[tick & TIMER_WHEEL_MASK];
+            }
+        }
+        timer = next;
+    }
+    return fired;
+}
+
+// Run the callbacks of every timer due by now_ns, returning how many fired.
+// Passes each slot at most once however long it has been.
+int timer_wheel_expire(struct timer_wheel *wheel, int64_t now_ns)
+{
+    int64_t now_tick = now_ns / TIMER_TICK_NS;
+    int fired = 0;
+
+    if (now_tick - wheel->tick > TIMER_WHEEL_SLOTS)
+    {
+        wheel->tick = now_tick - TIMER_WHEEL_SLOTS;
+    }
+
+    // Ticks that have completely elapsed
+    while (wheel->tick + 1 < now_tick)
+    {
+        wheel->tick++;
+        fired += expire_slot(wheel, wheel->tick, now_ns);
+    }
+
+    // The current tick is only partly over; revisit it next time
+    fired += expire_slot(wheel, now_tick, now_ns);
+    return fired;
+}
+
+// Earliest armed deadline, or -1 if nothing is armed. O(1) unless the
+// earliest timer fired or was cancelled since the last call; then the
+// slots are scanned once.
+int64_t timer_wheel_next_deadline(struct timer_wheel *wheel)
+{
+    if (wheel->earliest_stale)
+    {
+        int64_t earliest = -1;
+        for (int i = 0; i < TIMER_WHEEL_SLOTS; i++)
+        {
+            for (const struct timer *timer = wheel->slots[i]; timer; timer = timer->next)
+            {
+                if (earliest < 0 || timer->deadline_ns < earliest)
+                {
+                    earliest = timer->deadline_ns;
+                }
+            }
+        }
+        wheel->earliest_ns = earliest;
+        wheel->earliest_stale = 0;
+    }
+    return wheel->earliest_ns;
+}
+
+int64_t timer_remaining_ns(const struct timer *timer, int64_t now_ns)
+{
+    if (!timer->armed || timer->deadline_ns <= now_ns)
+    {
+        return 0;
+    }
+    return timer->deadline_ns - now_ns;
+}
+
+// Share of the armed period still to run, 1 when just armed, 0 when done
+float timer_fraction_remaining(const struct timer *timer, int64_t now_ns)
+{
+    int64_t period = timer->deadline_ns - timer->start_ns;
+    if (period <= 0)
+    {
+        return 0;
+    }
+    return (float)timer_remaining_ns(timer, now_ns) / period;
+}
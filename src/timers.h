@@ -0,0 +1,52 @@
+#ifndef TIMERS_H
+#define TIMERS_H
+
+#include <stdint.h>
+
+// Constants
+#define TIMER_WHEEL_SLOTS 256        // Must be a power of two
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_TICK_NS 10000000LL     // 10 ms per slot, one rotation is 2.56 s
+#define NS_PER_SECOND 1000000000LL
+
+// Struct definitions
+struct timer;
+typedef void (*timer_callback)(struct timer *timer);
+
+// Deadline timer. Deadlines are absolute nanoseconds on the caller's
+// monotonic clock, so re-arming from the previous deadline never drifts.
+struct timer
+{
+    int64_t start_ns;      // When it was armed, for progress
+    int64_t deadline_ns;
+    timer_callback callback;
+    void *arg;             // For the callback
+    int armed;
+    struct timer *next;    // Slot list
+    struct timer *prev;
+};
+
+// Hashed timing wheel: a timer lives in the slot of its deadline's tick,
+// whatever the rotation, and is only looked at when the wheel passes that
+// slot. Arming and cancelling are O(1). The earliest deadline is cached,
+// so looking it up only scans the slots after that timer went away.
+struct timer_wheel
+{
+    struct timer *slots[TIMER_WHEEL_SLOTS];
+    int64_t tick;          // Last tick whose slot has been fully processed
+    int armed_count;
+    int64_t earliest_ns;   // Next deadline, -1 with nothing armed
+    int earliest_stale;    // The timer at earliest_ns was removed; rescan
+};
+
+// Function declarations
+void timer_wheel_init(struct timer_wheel *wheel, int64_t now_ns);
+void timer_init(struct timer *timer, timer_callback callback, void *arg);
+void timer_arm(struct timer_wheel *wheel, struct timer *timer, int64_t start_ns, int64_t deadline_ns);
+void timer_cancel(struct timer_wheel *wheel, struct timer *timer);
+int timer_wheel_expire(struct timer_wheel *wheel, int64_t now_ns);
+int64_t timer_wheel_next_deadline(struct timer_wheel *wheel);
+int64_t timer_remaining_ns(const struct timer *timer, int64_t now_ns);
+float timer_fraction_remaining(const struct timer *timer, int64_t now_ns);
+
+#endif /* TIMERS_H */
@@ -0,0 +1,687 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <poll.h>
+#include "tui.h"
+#include "control.h"
+#include "hal.h"
+#include "log.h"
+#include "safety.h"
+#include "sampler.h"
+#include "layout.h"
+#include "screen.h"
+#include "editor.h"
+#include "sparkline.h"
+#include "watchdog.h"
+
+#define CLEAR_SCREEN "\033[2J"
+#define HIDE_CURSOR "\033[?25l"
+#define SHOW_CURSOR "\033[?25h"
+#define ESCAPE_DELAY_MS 25 // Longest gap inside one escape sequence
+#define CONTROL_TICK_NS (NS_PER_SECOND / 2) // Control and display cadence
+#define CHART_SPANS 3
+#define CHART_TOP 19     // Box row of the chart title; the plot starts below it
+#define CHART_BOTTOM -7  // Last plot row, just above the prompt separator
+#define CHART_QUEUE 64   // Control ticks the interface may fall behind by
+#define TUI_LOG_PATH "drier-tui.log" // Default log file; the terminal belongs to the interface
+
+// Struct definitions
+// One control tick, queued for the charts
+struct chart_point
+{
+    int64_t time_ns;
+    float temperature;
+    float setpoint;
+};
+
+// Global variables
+struct drier drier;
+pthread_mutex_t drier_lock = PTHREAD_MUTEX_INITIALIZER;
+static volatile sig_atomic_t shutdown = 0;
+static struct termios old_termios, new_termios;
+static int term_rows, term_cols;
+volatile sig_atomic_t window_changed = 0;
+static struct screen screen;
+static struct layout layout;
+
+// Timers on the drier's wheel, run by the control thread
+static void drying_done(struct timer *timer);
+static void countdown_second(struct timer *timer);
+static struct timer drying_timer = {.callback = drying_done};
+static struct timer countdown_timer = {.callback = countdown_second};
+int display_due = 0;
+static int frame_due = 0; // The interface itself changed something on screen
+
+// Inline editor state
+static struct line_editor editor;
+static int editing = EDIT_NONE;
+static const char *edit_error = NULL;
+static const char *edit_prompts[] = {NULL, "New temperature (°C): ", "Timer D:H:M:S: "};
+
+// Temperature history in the space between the timer and the prompt. Every
+// span is fed each control tick so switching between them is instant.
+static const int64_t chart_spans_ns[CHART_SPANS] = {600 * NS_PER_SECOND, 3600 * NS_PER_SECOND,
+                                                    8 * 3600 * NS_PER_SECOND};
+static const char *chart_span_names[CHART_SPANS] = {"10 min", "1 h", "8 h"};
+static struct sparkline charts[CHART_SPANS];
+static int chart_span = 0; // Index of the span on screen
+
+void setup_terminal(void)
+{
+    tcgetattr(STDIN_FILENO, &old_termios);
+    new_termios = old_termios;
+    new_termios.c_lflag &= ~(ICANON | ECHO);
+    tcsetattr(STDIN_FILENO, TCSANOW, &new_termios);
+    printf(HIDE_CURSOR);
+}
+
+void restore_terminal(void)
+{
+    printf(SHOW_CURSOR);
+    tcsetattr(STDIN_FILENO, TCSANOW, &old_termios);
+    screen_free(&screen);
+}
+
+void get_terminal_size(void)
+{
+    struct winsize w;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) < 0 || w.ws_row == 0 || w.ws_col == 0)
+    {
+        // Not a terminal: assume the classic size
+        w.ws_row = 24;
+        w.ws_col = 80;
+    }
+    term_rows = w.ws_row;
+    term_cols = w.ws_col;
+}
+
+// Drying countdown. The deadline is the only state: remaining time and
+// the percentage are derived from it in O(1), so nothing drifts. The
+// control thread picks the timers up at its next tick, well before the
+// first one is due.
+void start_drying(int seconds)
+{
+    int64_t now = control_clock_ns();
+
+    pthread_mutex_lock(&drier_lock);
+    if (seconds <= 0)
+    {
+        timer_cancel(&drier.timers, &drying_timer);
+        timer_cancel(&drier.timers, &countdown_timer);
+        display_due = 1;
+    }
+    else
+    {
+        timer_arm(&drier.timers, &drying_timer, now, now + seconds * NS_PER_SECOND);
+        // The displayed seconds change on whole seconds before the deadline
+        timer_arm(&drier.timers, &countdown_timer, now, now + NS_PER_SECOND);
+    }
+    pthread_mutex_unlock(&drier_lock);
+}
+
+static void drying_done(struct timer *timer)
+{
+    (void)timer;
+    timer_cancel(&drier.timers, &countdown_timer);
+    display_due = 1;
+}
+
+static void countdown_second(struct timer *timer)
+{
+    display_due = 1;
+    if (drying_timer.armed)
+    {
+        timer_arm(&drier.timers, timer, timer->start_ns, timer->deadline_ns + NS_PER_SECOND);
+    }
+}
+
+// Copy what the next frame shows out of the drier
+void take_snapshot(struct tui_snapshot *s)
+{
+    pthread_mutex_lock(&drier_lock);
+    int64_t now = control_clock_ns();
+    s->current_temp = sampler_latest_temperature(&drier);
+    s->desired_temp = drier.desired_temp;
+    s->is_heating = drier.heater_state;
+    s->drying_left_ns = timer_remaining_ns(&drying_timer, now);
+    s->drying_fraction = timer_fraction_remaining(&drying_timer, now);
+    pthread_mutex_unlock(&drier_lock);
+}
+
+// Panels of the interface. Positions are resolved against the terminal
+// size by layout_compute() only when it changes.
+enum
+{
+    FIELD_CURRENT_TEMP,
+    FIELD_DESIRED_TEMP,
+    FIELD_HEATER,
+    FIELD_TIMER,
+    FIELD_BAR,
+    FIELD_PERCENT,
+    FIELD_PROMPT,
+};
+
+static const struct layout_item panels[] = {
+    // Title
+    {2, LAYOUT_CENTER, -6, "TEMP CONTROL", LAYOUT_NO_FIELD, 0, NULL},
+    // Stats
+    {6, LAYOUT_CENTER, -15, "Current Temperature: ", FIELD_CURRENT_TEMP, 8, NULL},
+    {8, LAYOUT_CENTER, -15, "Desired Temperature: ", FIELD_DESIRED_TEMP, 8, NULL},
+    {10, LAYOUT_CENTER, -15, "Heater Status: ", FIELD_HEATER, 15, NULL},
+    // Timer
+    {13, LAYOUT_CENTER, -8, "TIME REMAINING:", LAYOUT_NO_FIELD, 0, NULL},
+    {14, LAYOUT_CENTER, -17, "Days    Hours    Minutes    Seconds", LAYOUT_NO_FIELD, 0, NULL},
+    {15, LAYOUT_CENTER, -18, NULL, FIELD_TIMER, 36, NULL},
+    // Loading bar and percentage below it
+    {16, LAYOUT_LEFT, 4, "[", FIELD_BAR, -10, "]"},
+    {17, LAYOUT_CENTER, -8, NULL, FIELD_PERCENT, 17, NULL},
+    // Inline editor, blank unless editing
+    {-5, LAYOUT_LEFT, 1, NULL, FIELD_PROMPT, -4, NULL},
+    // Controls
+    {-4, LAYOUT_LEFT, 1, "Press 'q' to quit", LAYOUT_NO_FIELD, 0, NULL},
+    {-3, LAYOUT_LEFT, 1, "Press 't' to set new timer", LAYOUT_NO_FIELD, 0, NULL},
+    {-2, LAYOUT_LEFT, 1, "Press 's' to set new temperature", LAYOUT_NO_FIELD, 0, NULL},
+};
+
+static const int separators[] = {4, 12, -6};
+
+// Write every field at its precomputed position
+static void write_fields(const struct tui_snapshot *s)
+{
+    layout_field_printf(&layout, &screen, FIELD_CURRENT_TEMP, "%6.1f°C", s->current_temp);
+    layout_field_printf(&layout, &screen, FIELD_DESIRED_TEMP, "%6.1f°C", s->desired_temp);
+    layout_field_text(&layout, &screen, FIELD_HEATER, s->is_heating ? "ON 🔥" : "OFF ❄️");
+    // Whole seconds left, rounded up so 0 only shows once the deadline passed
+    struct time left;
+    countdown_set(&left, (int)((s->drying_left_ns + NS_PER_SECOND - 1) / NS_PER_SECOND));
+    layout_field_printf(&layout, &screen, FIELD_TIMER, " %2d      %2d       %2d        %2d",
+                        left.days, left.hours, left.minutes, left.seconds);
+
+    float percentage = s->drying_fraction;
+    layout_field_bar(&layout, &screen, FIELD_BAR, percentage, "█");
+    layout_field_printf(&layout, &screen, FIELD_PERCENT, "%06.2f%% remaining", percentage * 100);
+
+    if (editing != EDIT_NONE)
+    {
+        const char *prompt = edit_prompts[editing];
+        const struct layout_field *field = &layout.fields[FIELD_PROMPT];
+        layout_field_printf(&layout, &screen, FIELD_PROMPT, "%s%-7s %s", prompt, editor.text,
+                            edit_error ? edit_error : "Enter=apply Esc=cancel");
+        screen_cursor(&screen, field->row, field->col + screen_text_width(prompt) + editor.cursor);
+    }
+    else
+    {
+        layout_field_text(&layout, &screen, FIELD_PROMPT, "");
+        screen_cursor(&screen, 0, 0);
+    }
+}
+
+// Fit every span to the box's current width; history is resampled
+static void place_charts(void)
+{
+    int width = layout.box_width - 4 - SPARKLINE_AXIS_WIDTH;
+    for (int i = 0; i < CHART_SPANS; i++)
+    {
+        if (charts[i].span_ns == 0)
+        {
+            sparkline_init(&charts[i], chart_spans_ns[i], width, control_clock_ns());
+        }
+        else
+        {
+            sparkline_resize(&charts[i], width);
+        }
+    }
+}
+
+// The chosen span in full, title included. Left out if the terminal is too
+// short to fit at least two rows of plot.
+static void draw_chart(void)
+{
+    int top = layout.box_row + CHART_TOP;
+    int height = layout.box_row + layout.box_height + CHART_BOTTOM - top;
+    int col = layout.box_col + 2;
+    if (height < 2)
+    {
+        sparkline_draw(&charts[chart_span], &screen, top + 1, col, 0);
+        return;
+    }
+
+    char title[96];
+    snprintf(title, sizeof(title), "Temperature, last %s  (█ range  ─ setpoint, 'h' changes span)",
+             chart_span_names[chart_span]);
+    screen_fill(&screen, top, col, layout.box_width - 4, " ");
+    screen_text_clipped(&screen, top, col, title, col + layout.box_width - 5);
+    sparkline_draw(&charts[chart_span], &screen, top + 1, col, height);
+}
+
+// Full repaint, for the first frame, after a prompt and after a resize.
+// The terminal size is only queried when SIGWINCH says it changed.
+void draw_interface(const struct tui_snapshot *s)
+{
+    if (layout.rows == 0 || window_changed)
+    {
+        get_terminal_size();
+        layout_compute(&layout, term_rows, term_cols, panels, sizeof(panels) / sizeof(panels[0]),
+                       separators, sizeof(separators) / sizeof(separators[0]));
+        if (screen.rows != term_rows || screen.cols != term_cols)
+        {
+            screen_resize(&screen, term_rows, term_cols);
+        }
+        place_charts();
+    }
+    screen_invalidate(&screen);
+
+    // Anything still buffered by stdio must reach the terminal first
+    fflush(stdout);
+    layout_draw(&layout, &screen);
+    draw_chart();
+    write_fields(s);
+    screen_flush(&screen, STDOUT_FILENO);
+}
+
+// Incremental frame: field writes only, and only changed cells are sent
+void update_values(const struct tui_snapshot *s)
+{
+    write_fields(s);
+    screen_flush(&screen, STDOUT_FILENO);
+}
+
+// Start editing the setpoint or the timer inline; the loop keeps running
+void start_edit(int kind)
+{
+    editing = kind;
+    edit_error = NULL;
+    editor_start(&editor, kind == EDIT_TEMPERATURE ? "0123456789.-" : "0123456789:");
+}
+
+// Validate and apply the edited value. Returns 0, with edit_error set, if
+// it is not acceptable.
+static int apply_edit(void)
+{
+    static char message[64];
+    char extra;
+
+    if (editing == EDIT_TEMPERATURE)
+    {
+        float new_temp;
+        if (sscanf(editor.text, "%f%c", &new_temp, &extra) != 1 || new_temp < 0 || new_temp >= MAX_TEMP)
+        {
+            snprintf(message, sizeof(message), "Enter 0 to %.0f°C", MAX_TEMP - 1);
+            edit_error = message;
+            return 0;
+        }
+        pthread_mutex_lock(&drier_lock);
+        drier.desired_temp = new_temp;
+        pthread_mutex_unlock(&drier_lock);
+        return 1;
+    }
+
+    struct time entered;
+    if (sscanf(editor.text, "%d:%d:%d:%d%c", &entered.days, &entered.hours,
+               &entered.minutes, &entered.seconds, &extra) != 4 ||
+        entered.days < 0 || entered.hours < 0 || entered.minutes < 0 || entered.seconds < 0)
+    {
+        edit_error = "Expected D:H:M:S, e.g. 0:1:30:0";
+        return 0;
+    }
+    start_drying(countdown_total_seconds(&entered));
+    return 1;
+}
+
+// One keystroke from the raw-mode terminal. Returns 0 to quit.
+int handle_key(char c)
+{
+    if (editing == EDIT_NONE)
+    {
+        if (c == 'q' || c == 'Q')
+        {
+            return 0;
+        }
+        else if (c == 's' || c == 'S')
+        {
+            start_edit(EDIT_TEMPERATURE);
+        }
+        else if (c == 't' || c == 'T')
+        {
+            start_edit(EDIT_TIMER);
+        }
+        else if ((c == 'h' || c == 'H') && layout.rows > 0)
+        {
+            chart_span = (chart_span + 1) % CHART_SPANS;
+            draw_chart();
+            frame_due = 1;
+        }
+        return 1;
+    }
+
+    edit_error = NULL;
+    int result = editor_key(&editor, c);
+    if ((result == EDITOR_ACCEPT && apply_edit()) || result == EDITOR_CANCEL)
+    {
+        editing = EDIT_NONE;
+    }
+    return 1;
+}
+
+// Signal handler for Ctrl+C
+void signal_handler(int signum)
+{
+    (void)signum;
+    shutdown = 1;
+}
+
+// Add new signal handler for window changes
+void window_change_handler(int signum)
+{
+    (void)signum;
+    window_changed = 1;
+}
+
+// The renderer benchmark drives the drawing functions itself
+#ifndef RENDER_BENCH
+static int control_due = 0;          // Set by the control tick timer
+static int control_running = 0;      // Under drier_lock; cleared to stop the thread
+static pthread_t control_thread;
+static pthread_cond_t control_stop;  // Wakes the control thread to stop it
+static int wake_fd = -1;             // eventfd: the control thread has a new frame
+
+// Ticks from the control thread not yet in the charts, under drier_lock
+static struct chart_point chart_queue[CHART_QUEUE];
+static unsigned chart_queued = 0;   // Points ever queued
+static unsigned chart_drawn = 0;    // Points ever taken by the interface
+
+// Control cadence; re-armed from its own deadline so it keeps phase
+static void control_tick_due(struct timer *timer)
+{
+    int64_t next = timer->deadline_ns + CONTROL_TICK_NS;
+    int64_t now = control_clock_ns();
+
+    control_due = 1;
+    timer_arm(&drier.timers, timer, timer->deadline_ns, next > now ? next : now + CONTROL_TICK_NS);
+}
+
+static struct timer control_timer = {.callback = control_tick_due};
+
+// Control thread: control ticks, countdown seconds, drying end and
+// setpoint reverts, each exactly when due. It holds drier_lock except
+// while it sleeps, and only tells the interface a frame is due.
+static void *control_main(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&drier_lock);
+    timer_arm(&drier.timers, &control_timer, control_clock_ns(), control_clock_ns());
+    while (control_running)
+    {
+        control_run_timers(&drier);
+        if (control_due)
+        {
+            int64_t tick_start = watchdog_clock_ns();
+            if (watchdog_tripped())
+            {
+                log_info("Watchdog: control loop recovered, heater control resumes");
+            }
+            float current_temp = sampler_latest_temperature(&drier);
+            control_heater(&drier, current_temp);
+            heater_service(&drier);
+
+            struct chart_point *point = &chart_queue[chart_queued++ % CHART_QUEUE];
+            point->time_ns = control_clock_ns();
+            point->temperature = current_temp;
+            point->setpoint = drier.desired_temp;
+            control_due = 0;
+            display_due = 1;
+            watchdog_heartbeat(tick_start);
+        }
+        uint64_t one = 1;
+        if (display_due && write(wake_fd, &one, sizeof(one)) == sizeof(one))
+        {
+            display_due = 0;
+        }
+
+        // The tick timer is always armed, so there is always a deadline
+        double next = control_next_deadline(&drier);
+        struct timespec until = {(time_t)next, (long)((next - (time_t)next) * 1e9)};
+        pthread_cond_timedwait(&control_stop, &drier_lock, &until);
+    }
+    pthread_mutex_unlock(&drier_lock);
+    return NULL;
+}
+
+static int start_control(void)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC); // The hal_time() clock
+    pthread_cond_init(&control_stop, &attr);
+    pthread_condattr_destroy(&attr);
+
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    control_running = 1;
+    if (wake_fd < 0 || pthread_create(&control_thread, NULL, control_main, NULL) != 0)
+    {
+        control_running = 0;
+        fprintf(stderr, "Failed to start control thread\n");
+        return -1;
+    }
+    return 0;
+}
+
+// Stop control and sampling, leaving the heater off
+static void stop_threads(void)
+{
+    pthread_mutex_lock(&drier_lock);
+    int running = control_running;
+    control_running = 0;
+    pthread_cond_signal(&control_stop);
+    pthread_mutex_unlock(&drier_lock);
+    if (running)
+    {
+        pthread_join(control_thread, NULL);
+    }
+    sampler_stop(&drier);
+    heater_set_duty(&drier, 0);
+}
+
+// Fold queued control ticks into every span; only the one on screen is
+// drawn, by scrolling rather than redrawing
+static void record_charts(void)
+{
+    struct chart_point points[CHART_QUEUE];
+    int count = 0;
+
+    pthread_mutex_lock(&drier_lock);
+    if (chart_queued - chart_drawn > CHART_QUEUE)
+    {
+        chart_drawn = chart_queued - CHART_QUEUE;
+    }
+    while (chart_drawn != chart_queued)
+    {
+        points[count++] = chart_queue[chart_drawn++ % CHART_QUEUE];
+    }
+    pthread_mutex_unlock(&drier_lock);
+
+    if (layout.rows == 0)
+    {
+        return;
+    }
+    for (int p = 0; p < count; p++)
+    {
+        for (int i = 0; i < CHART_SPANS; i++)
+        {
+            int closed = sparkline_add(&charts[i], points[p].time_ns, points[p].temperature, points[p].setpoint);
+            if (i == chart_span)
+            {
+                sparkline_update(&charts[i], &screen, closed);
+            }
+        }
+        frame_due = 1;
+    }
+}
+
+// Wait for keystrokes or a frame from the control thread and handle all
+// keys that are available. Returns 0 to quit.
+static int poll_input(void)
+{
+    struct pollfd pfds[2] = {{.fd = STDIN_FILENO, .events = POLLIN}, {.fd = wake_fd, .events = POLLIN}};
+    if (poll(pfds, 2, -1) <= 0)
+    {
+        return 1;
+    }
+    if (pfds[1].revents & POLLIN)
+    {
+        uint64_t frames;
+        if (read(wake_fd, &frames, sizeof(frames)) == sizeof(frames))
+        {
+            frame_due = 1;
+        }
+    }
+    if (!(pfds[0].revents & POLLIN))
+    {
+        return 1;
+    }
+
+    char keys[64];
+    ssize_t n;
+    do
+    {
+        while ((n = read(STDIN_FILENO, keys, sizeof(keys))) > 0)
+        {
+            for (ssize_t i = 0; i < n; i++)
+            {
+                if (!handle_key(keys[i]))
+                {
+                    return 0;
+                }
+            }
+        }
+        // Give the rest of an arrow key's escape sequence a moment to arrive
+    } while (editing != EDIT_NONE && editor.escape && poll(pfds, 1, ESCAPE_DELAY_MS) > 0);
+
+    // Anything still pending was the Esc key on its own
+    if (editing != EDIT_NONE && editor_idle(&editor) == EDITOR_CANCEL)
+    {
+        editing = EDIT_NONE;
+    }
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    // --log=FILE: where the controller logs (default drier-tui.log). Log
+    // lines never go to the terminal, where they would tear the screen.
+    const char *log_path = TUI_LOG_PATH;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--log=", 6) == 0)
+        {
+            log_path = argv[i] + 6;
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--log=FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (log_open(log_path) < 0)
+    {
+        return 1;
+    }
+
+    // Same controller as the daemon, on a thread of its own
+    if (hal_init() < 0)
+    {
+        fprintf(stderr, "Failed to initialize hardware\n");
+        return 1;
+    }
+    atexit(hal_terminate);
+    control_init(&drier, OUTPUT_SWITCHED);
+    drier.desired_temp = 21.0; // Default temperature
+    if (safety_init() < 0)
+    {
+        fprintf(stderr, "Failed to watch the thermostat and lid inputs\n");
+        return 1;
+    }
+
+    signal(SIGINT, signal_handler);
+    signal(SIGWINCH, window_change_handler); // Add window change signal handler
+
+    // Initialize interface
+    setup_terminal();
+    atexit(restore_terminal);
+
+    // Signals stay with this thread, so they interrupt its poll()
+    sigset_t mask, old_mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGWINCH);
+    pthread_sigmask(SIG_BLOCK, &mask, &old_mask);
+    // The control thread logs while holding drier_lock, so file I/O goes
+    // to the log writer; it stops after the threads that log
+    log_start();
+    atexit(log_stop);
+    // Every control tick heartbeats, as in drierd; a stalled control
+    // thread gets the heater switched off
+    int started = sampler_start(&drier) == 0 && start_control() == 0 &&
+                  watchdog_start(WATCHDOG_DEADLINE_MS * 1000000LL, NULL) == 0;
+    pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+    atexit(stop_threads);
+    atexit(watchdog_stop); // Before the control thread stops heartbeating
+    if (!started)
+    {
+        return 1;
+    }
+
+    // Make stdin non-blocking
+    int flags = fcntl(STDIN_FILENO, F_GETFL, 0);
+    fcntl(STDIN_FILENO, F_SETFL, flags | O_NONBLOCK);
+
+    struct tui_snapshot last = {-1, -1, -1, 0, 0};
+    int last_editing = EDIT_NONE;
+    int first_run = 1;
+
+    while (!shutdown)
+    {
+        struct tui_snapshot now;
+        take_snapshot(&now);
+
+        // Redraw full screen on first run or window size change
+        if (first_run || window_changed)
+        {
+            draw_interface(&now);
+            first_run = 0;
+            window_changed = 0;
+        }
+        record_charts();
+
+        // Update values only if they changed, a timer fired, or the editor
+        // has input to echo
+        if (now.current_temp != last.current_temp ||
+            now.desired_temp != last.desired_temp ||
+            now.is_heating != last.is_heating ||
+            editing != EDIT_NONE || editing != last_editing || frame_due)
+        {
+            update_values(&now);
+        }
+        frame_due = 0;
+
+        last = now;
+        last_editing = editing;
+
+        // Sleep until the control thread has a new frame or a key arrives
+        if (!poll_input())
+        {
+            printf(CLEAR_SCREEN);
+            break;
+        }
+    }
+
+    return 0;
+}
+#endif /* RENDER_BENCH */
@@ -0,0 +1,49 @@
+#ifndef TUI_H
+#define TUI_H
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include "control.h"
+#include "countdown.h"
+
+// Terminal interface. The controller runs on its own thread; the
+// interface copies what it shows out of the drier under drier_lock and
+// draws outside it, so a slow terminal never holds up a control tick.
+
+// Constants
+#define EDIT_NONE 0
+#define EDIT_TEMPERATURE 1
+#define EDIT_TIMER 2
+
+// Struct definitions
+// Everything one frame shows, taken in one go under drier_lock
+struct tui_snapshot
+{
+    float current_temp;
+    float desired_temp;
+    int is_heating;
+    int64_t drying_left_ns;    // 0 without a countdown
+    float drying_fraction;     // Share of the drying time left
+};
+
+// Global variables
+extern struct drier drier;
+extern pthread_mutex_t drier_lock; // Held by whichever thread touches `drier`
+extern int display_due;            // A control timer changed something on screen
+extern volatile sig_atomic_t window_changed;
+
+// Function declarations
+void setup_terminal(void);
+void restore_terminal(void);
+void get_terminal_size(void);
+void take_snapshot(struct tui_snapshot *s);
+void draw_interface(const struct tui_snapshot *s);
+void update_values(const struct tui_snapshot *s);
+void start_drying(int seconds);
+void start_edit(int kind);
+int handle_key(char c);
+void signal_handler(int signum);
+void window_change_handler(int signum);
+
+#endif /* TUI_H */
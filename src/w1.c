@@ -0,0 +1,154 @@
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include "hal.h"
+#include "log.h"
+#include "w1.h"
+
+// Find the DS18B20 probes and a bus master offering therm_bulk_read under
+// `root` (normally W1_SYSFS_ROOT). Returns the number of probes found.
+int w1_open(struct w1_bus *bus, const char *root)
+{
+    snprintf(bus->root, sizeof(bus->root), "%s", root);
+    bus->master[0] = '\0';
+    bus->probe_count = 0;
+
+    DIR *dir = opendir(root);
+    if (!dir)
+    {
+        log_error("Failed to open 1-Wire bus %s: %s", root, strerror(errno));
+        return -1;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        char path[W1_PATH_MAX];
+        int length;
+        if (strncmp(entry->d_name, W1_FAMILY_DS18B20, strlen(W1_FAMILY_DS18B20)) == 0 &&
+            bus->probe_count < W1_MAX_PROBES)
+        {
+            // Newer kernels expose a plain temperature file, older only w1_slave
+            length = snprintf(path, sizeof(path), "%s/%s/temperature", root, entry->d_name);
+            if (length >= (int)sizeof(path))
+            {
+                continue;
+            }
+            if (access(path, R_OK) != 0)
+            {
+                length = snprintf(path, sizeof(path), "%s/%s/w1_slave", root, entry->d_name);
+                if (length >= (int)sizeof(path))
+                {
+                    continue;
+                }
+            }
+            memcpy(bus->probes[bus->probe_count++], path, sizeof(path));
+        }
+        else if (strncmp(entry->d_name, "w1_bus_master", 13) == 0 && bus->master[0] == '\0')
+        {
+            length = snprintf(path, sizeof(path), "%s/%s/therm_bulk_read", root, entry->d_name);
+            if (length < (int)sizeof(path) && access(path, W_OK) == 0)
+            {
+                memcpy(bus->master, path, sizeof(path));
+            }
+        }
+    }
+    closedir(dir);
+    return bus->probe_count;
+}
+
+// Start a Convert T on every probe at once. Returns 0 once all are done.
+static int w1_bulk_convert(struct w1_bus *bus)
+{
+    FILE *file = fopen(bus->master, "w");
+    if (!file)
+    {
+        return -1;
+    }
+    fputs("trigger\n", file);
+    if (fclose(file) != 0)
+    {
+        return -1;
+    }
+
+    // therm_bulk_read reads -1 while any conversion is still running
+    hal_sleep(W1_CONVERSION_TIME);
+    for (double waited = W1_CONVERSION_TIME; waited < 2 * W1_CONVERSION_TIME; waited += W1_POLL_INTERVAL)
+    {
+        int status;
+        file = fopen(bus->master, "r");
+        if (!file)
+        {
+            return -1;
+        }
+        int parsed = fscanf(file, "%d", &status);
+        fclose(file);
+        if (parsed == 1 && status >= 0)
+        {
+            return 0;
+        }
+        hal_sleep(W1_POLL_INTERVAL);
+    }
+    return -1;
+}
+
+// Millidegrees from either format. The plain temperature file holds just
+// the value. w1_slave has the scratchpad and a CRC verdict on its first
+// line and "t=" on its second; anything else there is a failed read.
+// W1_POWER_ON_RESET means the probe never converted, so it fails too.
+static float w1_read_probe(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        return -1;
+    }
+
+    size_t length = strlen(path);
+    int plain = length >= 12 && strcmp(path + length - 12, "/temperature") == 0;
+    char line[128];
+    int millidegrees = 0;
+    int found = 0;
+    if (plain)
+    {
+        found = fgets(line, sizeof(line), file) && sscanf(line, "%d", &millidegrees) == 1;
+    }
+    else if (fgets(line, sizeof(line), file) && strstr(line, "crc=") && strstr(line, "YES") &&
+             fgets(line, sizeof(line), file))
+    {
+        char *t = strstr(line, "t=");
+        found = t && sscanf(t + 2, "%d", &millidegrees) == 1;
+    }
+    fclose(file);
+
+    if (!found || millidegrees == W1_POWER_ON_RESET)
+    {
+        return -1;
+    }
+    return millidegrees / 1000.0f;
+}
+
+// Read every probe. With bulk read support all conversions run in
+// parallel, so N probes cost one conversion time rather than N. Failed
+// probes read -1. Returns the number of valid readings.
+int w1_read_all(struct w1_bus *bus, float *temps)
+{
+    int bulk = bus->master[0] != '\0' && w1_bulk_convert(bus) == 0;
+    if (bus->master[0] != '\0' && !bulk)
+    {
+        log_warn("1-Wire bulk conversion failed, reading probes one by one");
+    }
+
+    int valid = 0;
+    for (int i = 0; i < bus->probe_count; i++)
+    {
+        temps[i] = w1_read_probe(bus->probes[i]);
+        if (temps[i] >= 0)
+        {
+            valid++;
+        }
+    }
+    return valid;
+}
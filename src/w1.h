@@ -0,0 +1,26 @@
+#ifndef W1_H
+#define W1_H
+
+// Constants
+#define W1_SYSFS_ROOT "/sys/bus/w1/devices"
+#define W1_MAX_PROBES 8
+#define W1_FAMILY_DS18B20 "28-"
+#define W1_CONVERSION_TIME 0.75 // 12-bit DS18B20 conversion
+#define W1_POLL_INTERVAL 0.05   // Bulk conversion status polling
+#define W1_POWER_ON_RESET 85000 // Scratchpad value before any conversion
+#define W1_PATH_MAX 256
+
+// Struct definitions
+struct w1_bus
+{
+    char root[W1_PATH_MAX];
+    char master[W1_PATH_MAX];                   // Empty if no bulk read support
+    char probes[W1_MAX_PROBES][W1_PATH_MAX];    // Temperature file per probe
+    int probe_count;
+};
+
+// Function declarations
+int w1_open(struct w1_bus *bus, const char *root);
+int w1_read_all(struct w1_bus *bus, float *temps);
+
+#endif /* W1_H */
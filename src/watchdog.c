@@ -0,0 +1,218 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "log.h"
+#include "safety.h"
+#include "watchdog.h"
+
+// Global variables
+struct watchdog_stats watchdog_stats;
+
+static pthread_t monitor_thread;
+static pthread_mutex_t monitor_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t monitor_wake;
+static int monitor_running = 0; // Guarded by monitor_lock
+static int64_t deadline_ns;
+static int device_fd = -1;
+static _Atomic int tripped = 0;
+
+int64_t watchdog_clock_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void store_max(_Atomic int64_t *worst, int64_t value)
+{
+    if (value > atomic_load(worst))
+    {
+        atomic_store(worst, value);
+    }
+}
+
+// Any write keeps the kernel watchdog from resetting the board
+static void feed_device(void)
+{
+    if (device_fd >= 0 && write(device_fd, "1", 1) == 1)
+    {
+        atomic_fetch_add(&watchdog_stats.feeds, 1);
+    }
+}
+
+// Heaters first, then the bookkeeping. The log line goes straight to
+// stderr because the loop that would normally print it is the one stuck.
+static void missed_deadline(int64_t due)
+{
+    atomic_store(&tripped, 1);
+    safety_trip(SAFETY_WATCHDOG);
+
+    int64_t now = watchdog_clock_ns();
+    atomic_store(&watchdog_stats.last_miss_ns, now);
+    atomic_fetch_add(&watchdog_stats.missed, 1);
+    store_max(&watchdog_stats.worst_detect_ns, now - due);
+
+    char message[96];
+    int length = snprintf(message, sizeof(message), "Watchdog: no heartbeat for %lld ms, heater off\n",
+                          (long long)((now - atomic_load(&watchdog_stats.last_heartbeat_ns)) / 1000000));
+    if (write(STDERR_FILENO, message, length) < 0)
+    {
+        // Nothing better to do with it
+    }
+}
+
+// Sleeps until the heartbeat deadline or the next feed, whichever is
+// first. A trip stops the feeding, so if the loop never recovers the
+// kernel watchdog resets the board.
+static void *monitor_main(void *arg)
+{
+    (void)arg;
+    int64_t next_feed = watchdog_clock_ns();
+
+    pthread_mutex_lock(&monitor_lock);
+    while (monitor_running)
+    {
+        int64_t now = watchdog_clock_ns();
+        int64_t due = atomic_load(&watchdog_stats.last_heartbeat_ns) + deadline_ns;
+        if (now >= due && !atomic_load(&tripped))
+        {
+            missed_deadline(due);
+        }
+
+        int64_t wake;
+        if (atomic_load(&tripped))
+        {
+            // Idle until the heartbeat that clears the trip wakes us
+            wake = now + WATCHDOG_FEED_MS * 1000000LL;
+        }
+        else
+        {
+            if (device_fd >= 0 && now >= next_feed)
+            {
+                feed_device();
+                next_feed = now + WATCHDOG_FEED_MS * 1000000LL;
+            }
+            wake = (device_fd >= 0 && next_feed < due) ? next_feed : due;
+        }
+
+        struct timespec ts = {wake / 1000000000LL, wake % 1000000000LL};
+        pthread_cond_timedwait(&monitor_wake, &monitor_lock, &ts);
+    }
+    pthread_mutex_unlock(&monitor_lock);
+    return NULL;
+}
+
+// Start monitoring with heartbeats due every `deadline` ns. `device` is
+// fed while the loop is healthy; NULL runs without one. Any writable file
+// stands in for /dev/watchdog in tests.
+int watchdog_start(int64_t deadline, const char *device)
+{
+    deadline_ns = deadline;
+    atomic_store(&tripped, 0);
+    atomic_store(&watchdog_stats.last_heartbeat_ns, watchdog_clock_ns());
+
+    if (device)
+    {
+        device_fd = open(device, O_WRONLY | O_CLOEXEC);
+        if (device_fd < 0)
+        {
+            log_error("Cannot open watchdog %s: %s", device, strerror(errno));
+            return -1;
+        }
+    }
+
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&monitor_wake, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+
+    pthread_attr_t attr;
+    struct sched_param param = {.sched_priority = WATCHDOG_PRIORITY};
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    pthread_attr_setschedparam(&attr, &param);
+
+    monitor_running = 1;
+    int created = pthread_create(&monitor_thread, &attr, monitor_main, NULL) == 0;
+    if (!created)
+    {
+        // Without CAP_SYS_NICE a normal-priority monitor beats none
+        created = pthread_create(&monitor_thread, NULL, monitor_main, NULL) == 0;
+    }
+    pthread_attr_destroy(&attr);
+
+    if (!created)
+    {
+        monitor_running = 0;
+        log_error("Failed to start watchdog thread");
+        if (device_fd >= 0)
+        {
+            close(device_fd);
+            device_fd = -1;
+        }
+        return -1;
+    }
+    return 0;
+}
+
+// Stop monitoring. The device gets the magic close character, so a clean
+// shutdown does not reset the board.
+void watchdog_stop(void)
+{
+    pthread_mutex_lock(&monitor_lock);
+    int running = monitor_running;
+    monitor_running = 0;
+    pthread_cond_signal(&monitor_wake);
+    pthread_mutex_unlock(&monitor_lock);
+    if (!running)
+    {
+        return;
+    }
+
+    pthread_join(monitor_thread, NULL);
+    pthread_cond_destroy(&monitor_wake);
+    if (device_fd >= 0)
+    {
+        if (write(device_fd, "V", 1) < 0)
+        {
+            log_warn("Cannot disarm watchdog: %s", strerror(errno));
+        }
+        close(device_fd);
+        device_fd = -1;
+    }
+}
+
+// End of a control cycle that began at `cycle_start_ns`
+// (watchdog_clock_ns()). Clears a trip: the loop is alive again and the
+// next cycle may switch the heater back on. A heartbeat racing the trip
+// can leave it set until the following one, which errs on the safe side.
+void watchdog_heartbeat(int64_t cycle_start_ns)
+{
+    int64_t now = watchdog_clock_ns();
+    atomic_store(&watchdog_stats.last_cycle_ns, now - cycle_start_ns);
+    store_max(&watchdog_stats.worst_cycle_ns, now - cycle_start_ns);
+    atomic_fetch_add(&watchdog_stats.cycles, 1);
+    atomic_store(&watchdog_stats.last_heartbeat_ns, now);
+
+    if (atomic_exchange(&tripped, 0))
+    {
+        safety_clear(SAFETY_WATCHDOG);
+
+        // The monitor is idling while tripped; it has a deadline again
+        pthread_mutex_lock(&monitor_lock);
+        pthread_cond_signal(&monitor_wake);
+        pthread_mutex_unlock(&monitor_lock);
+    }
+}
+
+int watchdog_tripped(void)
+{
+    return atomic_load(&tripped);
+}
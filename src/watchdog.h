@@ -0,0 +1,37 @@
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Constants
+#define WATCHDOG_DEADLINE_MS 12000 // Longest gap between heartbeats: two control ticks plus slack
+#define WATCHDOG_FEED_MS 1000      // How often /dev/watchdog is fed while the loop is healthy
+#define WATCHDOG_PRIORITY 80       // SCHED_FIFO priority of the monitor, when permitted
+#define WATCHDOG_DEVICE "/dev/watchdog"
+
+// Struct definitions
+// Updated by the control loop (cycles) and the monitor (misses), read by anyone
+struct watchdog_stats
+{
+    _Atomic unsigned long cycles;
+    _Atomic unsigned long missed;       // Deadlines the control loop missed
+    _Atomic int64_t last_cycle_ns;      // Start of a cycle to its heartbeat
+    _Atomic int64_t worst_cycle_ns;
+    _Atomic int64_t last_heartbeat_ns;  // CLOCK_MONOTONIC
+    _Atomic int64_t last_miss_ns;       // When the monitor last cut the heaters
+    _Atomic int64_t worst_detect_ns;    // Deadline to heaters cut
+    _Atomic unsigned long feeds;        // Writes to the watchdog device
+};
+
+// Global variables
+extern struct watchdog_stats watchdog_stats;
+
+// Function declarations
+int64_t watchdog_clock_ns(void);
+int watchdog_start(int64_t deadline_ns, const char *device);
+void watchdog_stop(void);
+void watchdog_heartbeat(int64_t cycle_start_ns);
+int watchdog_tripped(void);
+
+#endif /* WATCHDOG_H */
@@ -0,0 +1,276 @@
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "control.h"
+#include "hal.h"
+#include "latency.h"
+#include "log.h"
+#include "pid.h"
+#include "rt.h"
+#include "safety.h"
+#include "sampler.h"
+#include "zones.h"
+
+static void zone_revert(struct timer *timer)
+{
+    struct zone_table *zones = timer->arg;
+    int zone = timer - zones->revert;
+    zones->desired_temp[zone] = zones->default_temp[zone];
+}
+
+// Zones share `drier`'s output mode, timer wheel and sensor counters
+void zones_init(struct zone_table *zones, struct drier *drier)
+{
+    zones->count = 0;
+    zones->drier = drier;
+    zones->last_control = -1;
+    atomic_store(&zones->sampler_running, 0);
+}
+
+// Returns the new zone's index, or -1 if the table is full
+int zones_add(struct zone_table *zones, int sensor_channel, int heater_pin, float default_temp)
+{
+    if (zones->count >= MAX_ZONES)
+    {
+        return -1;
+    }
+
+    int i = zones->count++;
+    zones->sensor_channel[i] = sensor_channel;
+    zones->heater_pin[i] = heater_pin;
+    zones->default_temp[i] = default_temp;
+    zones->desired_temp[i] = default_temp;
+    zones->current_temp[i] = -1;
+    zones->duty[i] = 0;
+    zones->kp[i] = 0;
+    zones->ki[i] = 0;
+    zones->kd[i] = 0;
+    zones->integral[i] = 0;
+    zones->prev_measurement[i] = 0;
+    zones->pid_initialized[i] = 0;
+    zones->sampled_ns[i] = 0;
+    atomic_store_explicit(&zones->samples[i].sequence, 0, memory_order_relaxed);
+    timer_init(&zones->revert[i], zone_revert, zones);
+
+    hal_register_zone(sensor_channel, heater_pin);
+    filter_init(&zones->filter[i]);
+    output_init(&zones->output[i], heater_pin, zones->drier->output_mode);
+    safety_protect(heater_pin);
+    return i;
+}
+
+// Zone table from a text file, one zone per line:
+//   sensor_channel heater_pin default_temp [kp ki kd]
+// Blank lines and lines starting with '#' are ignored. Channels the ADC
+// does not have are rejected rather than left to alias another input.
+int zones_load(struct zone_table *zones, const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        log_error("Failed to open zone configuration %s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    char line[ZONE_LINE_MAX];
+    int line_number = 0;
+    while (fgets(line, sizeof(line), file))
+    {
+        int channel, pin;
+        float default_temp, kp, ki, kd;
+        line_number++;
+
+        if (line[0] == '#' || line[0] == '\n')
+        {
+            continue;
+        }
+        int fields = sscanf(line, "%d %d %f %f %f %f", &channel, &pin, &default_temp, &kp, &ki, &kd);
+        if (fields != 3 && fields != 6)
+        {
+            log_error("%s:%d: expected 'channel pin default_temp [kp ki kd]'", path, line_number);
+            fclose(file);
+            return -1;
+        }
+        if (channel < 0 || channel >= hal_sensor_channels())
+        {
+            log_error("%s:%d: sensor channel %d out of range 0-%d", path, line_number, channel,
+                      hal_sensor_channels() - 1);
+            fclose(file);
+            return -1;
+        }
+
+        int zone = zones_add(zones, channel, pin, default_temp);
+        if (zone < 0)
+        {
+            log_error("%s:%d: more than %d zones", path, line_number, MAX_ZONES);
+            fclose(file);
+            return -1;
+        }
+        if (fields == 6)
+        {
+            zones->kp[zone] = kp;
+            zones->ki[zone] = ki;
+            zones->kd[zone] = kd;
+        }
+    }
+    fclose(file);
+    return zones->count;
+}
+
+// Hold a setpoint on one zone for `duration` seconds, then revert to its default
+void zones_set_temporary(struct zone_table *zones, int zone, float temp, int duration)
+{
+    int64_t now = control_clock_ns();
+
+    zones->desired_temp[zone] = temp;
+    if (duration > 0)
+    {
+        timer_arm(&zones->drier->timers, &zones->revert[zone], now, now + duration * NS_PER_SECOND);
+    }
+    else
+    {
+        timer_cancel(&zones->drier->timers, &zones->revert[zone]);
+    }
+}
+
+// Read every zone's sensor through the same filter as the single drier
+// and publish the results. Blocks on the ADC, so the daemon runs it on the
+// zone sampler thread, never on the control tick.
+void zones_sample(struct zone_table *zones)
+{
+    int64_t start = monotonic_ns();
+    for (int i = 0; i < zones->count; i++)
+    {
+        float temperature = read_analog_temperature(zones->drier, zones->sensor_channel[i],
+                                                    zones->heater_pin[i], &zones->filter[i]);
+        sample_slot_publish(&zones->samples[i], monotonic_ns(), temperature, zones->filter[i].variance);
+    }
+    latency_mark(LATENCY_ACQUIRE, start);
+}
+
+static void *zones_sampler_main(void *arg)
+{
+    struct zone_table *zones = arg;
+    rt_enter();
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while (atomic_load(&zones->sampler_running))
+    {
+        zones_sample(zones);
+        sampler_wait(&next);
+    }
+    return NULL;
+}
+
+// Sweep all zones every SAMPLER_INTERVAL_MS on a thread of their own, as
+// sampler_start does for the single drier
+int zones_sampler_start(struct zone_table *zones)
+{
+    atomic_store(&zones->sampler_running, 1);
+    if (pthread_create(&zones->sampler_thread, NULL, zones_sampler_main, zones) != 0)
+    {
+        atomic_store(&zones->sampler_running, 0);
+        log_error("Failed to start zone sampling thread");
+        return -1;
+    }
+    return 0;
+}
+
+void zones_sampler_stop(struct zone_table *zones)
+{
+    if (atomic_exchange(&zones->sampler_running, 0))
+    {
+        pthread_join(zones->sampler_thread, NULL);
+    }
+}
+
+// Latest published reading of every zone into current_temp. Never blocks:
+// a slot being written keeps the previous reading, and readings older
+// than SAMPLE_MAX_AGE_MS count as a sensor failure.
+void zones_acquire(struct zone_table *zones)
+{
+    int64_t now = monotonic_ns();
+    for (int i = 0; i < zones->count; i++)
+    {
+        struct sample sample;
+        if (sample_slot_read(&zones->samples[i], &sample))
+        {
+            zones->current_temp[i] = sample.temperature;
+            zones->sampled_ns[i] = sample.timestamp_ns;
+        }
+        if (now - zones->sampled_ns[i] > SAMPLE_MAX_AGE_MS * 1000000LL)
+        {
+            zones->current_temp[i] = -1;
+        }
+    }
+}
+
+// One scheduler pass over all zones: setpoint reverts, control law, output
+void zones_control(struct zone_table *zones, double now)
+{
+    int n = zones->count;
+    float dt = zones->last_control < 0 ? 0 : now - zones->last_control;
+    zones->last_control = now;
+
+    // Setpoint reverts that are due
+    timer_wheel_expire(&zones->drier->timers, (int64_t)(now * NS_PER_SECOND));
+
+    for (int i = 0; i < n; i++)
+    {
+        float current = zones->current_temp[i];
+        float desired = zones->desired_temp[i];
+
+        // If we got an error reading temperature, turn off heater for safety
+        if (current < 0 || desired >= MAX_TEMP)
+        {
+            zones->duty[i] = 0;
+        }
+        else if (zones->kp[i] > 0)
+        {
+            zones->duty[i] = pid_compute(zones->kp[i], zones->ki[i], zones->kd[i],
+                                         &zones->integral[i], &zones->prev_measurement[i],
+                                         &zones->pid_initialized[i], desired, current, dt);
+        }
+        else if (current < desired - TEMP_TOLERANCE)
+        {
+            zones->duty[i] = 1;
+        }
+        else if (current > desired + TEMP_TOLERANCE)
+        {
+            zones->duty[i] = 0;
+        }
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        output_set_duty(&zones->output[i], zones->duty[i], now);
+    }
+}
+
+// Time-proportioning edges for every zone. Returns the earliest next
+// edge, or -1 if no zone needs servicing.
+double zones_service(struct zone_table *zones, double now)
+{
+    double earliest = -1;
+    for (int i = 0; i < zones->count; i++)
+    {
+        double next = output_service(&zones->output[i], now);
+        if (next >= 0 && (earliest < 0 || next < earliest))
+        {
+            earliest = next;
+        }
+    }
+    return earliest;
+}
+
+void zones_all_off(struct zone_table *zones)
+{
+    double now = hal_time();
+    for (int i = 0; i < zones->count; i++)
+    {
+        zones->duty[i] = 0;
+        output_set_duty(&zones->output[i], 0, now);
+    }
+}
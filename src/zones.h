@@ -0,0 +1,66 @@
+#ifndef ZONES_H
+#define ZONES_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include "control.h"
+#include "filter.h"
+#include "output.h"
+#include "sample_ring.h"
+#include "timers.h"
+
+// Constants
+#define MAX_ZONES 512
+#define ZONE_LINE_MAX 128
+
+// Struct definitions
+// Every drier in the rack is one index into these arrays. Fields the
+// control pass touches every tick are kept in separate contiguous arrays,
+// so stepping N zones streams through a few cache lines per field
+// instead of striding over whole per-zone records.
+struct zone_table
+{
+    int count;
+    struct drier *drier;              // Output mode, timers and sensor counters
+
+    // Hot: read and written by every control pass
+    float current_temp[MAX_ZONES];
+    float desired_temp[MAX_ZONES];
+    float duty[MAX_ZONES];
+    float kp[MAX_ZONES];            // Zero selects on/off control
+    float ki[MAX_ZONES];
+    float kd[MAX_ZONES];
+    float integral[MAX_ZONES];
+    float prev_measurement[MAX_ZONES];
+    int pid_initialized[MAX_ZONES];
+
+    float default_temp[MAX_ZONES];
+
+    // Cold: configuration and per-zone acquisition/output state
+    int sensor_channel[MAX_ZONES];
+    int heater_pin[MAX_ZONES];
+    struct temp_filter filter[MAX_ZONES];   // Owned by whoever runs zones_sample
+    struct sample_slot samples[MAX_ZONES];  // Latest filtered reading per zone
+    int64_t sampled_ns[MAX_ZONES];          // When current_temp was acquired
+    struct output_stage output[MAX_ZONES];
+    struct timer revert[MAX_ZONES];   // Setpoint reverts on the drier's timers
+
+    double last_control;
+    pthread_t sampler_thread;
+    atomic_int sampler_running;
+};
+
+// Function declarations
+void zones_init(struct zone_table *zones, struct drier *drier);
+int zones_add(struct zone_table *zones, int sensor_channel, int heater_pin, float default_temp);
+int zones_load(struct zone_table *zones, const char *path);
+void zones_set_temporary(struct zone_table *zones, int zone, float temp, int duration);
+void zones_sample(struct zone_table *zones);
+int zones_sampler_start(struct zone_table *zones);
+void zones_sampler_stop(struct zone_table *zones);
+void zones_acquire(struct zone_table *zones);
+void zones_control(struct zone_table *zones, double now);
+double zones_service(struct zone_table *zones, double now);
+void zones_all_off(struct zone_table *zones);
+
+#endif /* ZONES_H */